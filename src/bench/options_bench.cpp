@@ -0,0 +1,350 @@
+// Benchmarks of the hot paths of the library: parsing, accessors, conversions and the help text.
+//
+// Every benchmark reports the time and the number of heap allocations per operation. The allocations
+// are counted by replacing the global operator new, so they include the ones made by the standard library.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "options/Converters.hpp"
+#include "options/Parser.hpp"
+
+namespace
+{
+    std::atomic<uint64_t> allocation_count{0};
+
+    // Prevents the compiler from optimizing away a computed value.
+    volatile uint64_t sink = 0;
+
+    template <typename T>
+    void keep(const T &value)
+    {
+        sink = sink + static_cast<uint64_t>(value);
+    }
+
+    struct Settings
+    {
+        double min_time_ms = 100.0;
+        std::string filter;
+    };
+
+    Settings settings;
+
+    // Runs the function (which performs a single operation) until min_time_ms elapsed and prints the results.
+    template <typename Function>
+    void run(const std::string &name, Function &&function)
+    {
+        if (!settings.filter.empty() && name.find(settings.filter) == std::string::npos)
+            return;
+
+        using Clock = std::chrono::steady_clock;
+
+        function(); // warm up
+
+        uint64_t iterations = 1;
+
+        while (true)
+        {
+            const uint64_t allocations_before = allocation_count.load();
+            const auto start = Clock::now();
+
+            for (uint64_t i = 0; i < iterations; ++i)
+                function();
+
+            const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            const uint64_t allocations = allocation_count.load() - allocations_before;
+
+            if (elapsed >= settings.min_time_ms * 1e6 || iterations >= (1ULL << 40))
+            {
+                printf("%-44s %14.1f ns/op %10.2f allocs/op %12llu iterations\n", name.c_str(),
+                       elapsed / static_cast<double>(iterations),
+                       static_cast<double>(allocations) / static_cast<double>(iterations),
+                       static_cast<unsigned long long>(iterations));
+                return;
+            }
+
+            iterations *= 2;
+        }
+    }
+
+    // Command line with the given number of options set, every one with a value, then a few positionals.
+    class Command_Line
+    {
+    public:
+        Command_Line(size_t options_given, size_t option_count)
+        {
+            _texts.emplace_back("bench");
+
+            for (size_t i = 0; i < options_given; ++i)
+            {
+                const size_t option = (i * 7919) % option_count; // spread over all the options
+                _texts.emplace_back("--option_" + std::to_string(option));
+                _texts.emplace_back(std::to_string(i));
+            }
+
+            _texts.emplace_back("--");
+            for (size_t i = 0; i < 4; ++i)
+                _texts.emplace_back("positional_" + std::to_string(i));
+
+            for (const auto &text: _texts)
+                _argv.push_back(text.c_str());
+        }
+
+        int argc() const { return static_cast<int>(_argv.size()); }
+        const char *const *argv() const { return _argv.data(); }
+
+    private:
+        std::vector<std::string> _texts;
+        std::vector<const char *> _argv;
+    };
+
+    void add_options(Options::Parser &parser, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const std::string name = "option_" + std::to_string(i);
+            parser.add_optional(name, "Option number " + std::to_string(i), "0");
+        }
+    }
+
+    void bench_parse()
+    {
+        const size_t OPTION_COUNTS[] = {10, 100, 1000, 5000};
+        const size_t GIVEN_COUNTS[] = {1, 10, 100, 1000};
+
+        for (const size_t option_count: OPTION_COUNTS)
+        {
+            Options::Parser parser;
+            add_options(parser, option_count);
+            parser.freeze();
+
+            Options::Parse_Result result;
+
+            for (const size_t given: GIVEN_COUNTS)
+            {
+                const Command_Line command_line(given, option_count);
+                const std::string suffix = "/" + std::to_string(option_count) + "/" + std::to_string(given);
+
+                parser.set_zero_copy(false);
+                run("parse" + suffix, [&]() {
+                    parser.reset();
+                    keep(parser.parse(command_line.argc(), command_line.argv()));
+                });
+
+                // parsing into a result resets it first
+                run("parse_into_result" + suffix, [&]() {
+                    keep(parser.parse(command_line.argc(), command_line.argv(), result));
+                });
+
+                parser.set_zero_copy(true);
+                run("parse_zero_copy" + suffix, [&]() {
+                    parser.reset();
+                    keep(parser.parse(command_line.argc(), command_line.argv()));
+                });
+
+                run("parse_into_result_zero_copy" + suffix, [&]() {
+                    keep(parser.parse(command_line.argc(), command_line.argv(), result));
+                });
+            }
+        }
+    }
+
+    void bench_snapshot()
+    {
+        Options::Parser parser;
+        add_options(parser, 1000);
+        parser.freeze();
+
+        const Command_Line command_line(100, 1000);
+        Options::Parse_Result result;
+        parser.parse(command_line.argc(), command_line.argv(), result);
+
+        const std::string snapshot = parser.save_snapshot(result);
+
+        run("snapshot/save/1000/100", [&]() { keep(parser.save_snapshot(result).size()); });
+        run("snapshot/load/1000/100", [&]() { keep(parser.load_snapshot(snapshot.data(), snapshot.size(), result)); });
+    }
+
+    void bench_apply()
+    {
+        Options::Parser parser;
+        add_options(parser, 1000);
+
+        const Command_Line command_line(100, 1000);
+        parser.parse(command_line.argc(), command_line.argv());
+
+        // alternating values, so every apply changes the option
+        const char *tokens[][2] = {{"--option_42", "1"}, {"--option_42", "2"}};
+        size_t next = 0;
+        std::vector<Options::Handle> changed;
+
+        run("apply/1000/1", [&]() {
+            next ^= 1;
+            keep(parser.apply(2, tokens[next], &changed));
+        });
+    }
+
+    void bench_response_file()
+    {
+        const size_t POSITIONAL_COUNT = 100000;
+        const char *const directory = getenv("TMPDIR");
+        const std::string path =
+            std::string(directory != nullptr && *directory != '\0' ? directory : "/tmp") + "/options_bench.rsp";
+
+        FILE *file = fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return;
+
+        fputs("--option_1 1 --", file);
+        for (size_t i = 0; i < POSITIONAL_COUNT; ++i)
+            fprintf(file, " /some/path/to/a/file_%zu.txt", i);
+        fclose(file);
+
+        Options::Parser parser;
+        add_options(parser, 10);
+        parser.set_response_files(true);
+
+        const std::string at_path = "@" + path;
+        const char *argv[] = {"bench", at_path.c_str()};
+
+        run("parse_response_file/" + std::to_string(POSITIONAL_COUNT), [&]() {
+            parser.reset();
+            keep(parser.parse(2, argv));
+        });
+
+        remove(path.c_str());
+    }
+
+    void bench_accessors()
+    {
+        Options::Parser parser;
+        add_options(parser, 100);
+
+        const Command_Line command_line(100, 100);
+        parser.parse(command_line.argc(), command_line.argv());
+
+        const std::string name = "option_42";
+        const Options::Handle handle = parser.find(name);
+
+        run("as_int/name", [&]() { keep(parser.as_int(name)); });
+        run("as_int/handle", [&]() { keep(parser.as_int(handle)); });
+        run("as_int64/handle", [&]() { keep(parser.as_int64(handle)); });
+        run("as_double/handle", [&]() { keep(parser.as_double(handle)); });
+        run("as_string/name", [&]() { keep(parser.as_string(name).size()); });
+        run("as_string/handle", [&]() { keep(parser.as_string(handle).size()); });
+        run("positional", [&]() { keep(parser.positional(3).size()); });
+        run("as_view/name", [&]() { keep(parser.as_view(name).size()); });
+        run("as_view/handle", [&]() { keep(parser.as_view(handle).size()); });
+        run("positional_view", [&]() { keep(parser.positional_view(3).size()); });
+    }
+
+    void bench_converters()
+    {
+        const std::string INTEGER = "1234567890";
+        const std::string HEX = "0x7fffffffffff";
+        const std::string REAL = "3.14159265358979";
+        const std::string LONG_REAL = "2.718281828459045235360287471352662497757";
+
+        run("converter/as_int", [&]() { keep(Options::as_int(INTEGER)); });
+        run("converter/as_double", [&]() { keep(Options::as_double(REAL) > 0); });
+
+        int64_t int64 = 0;
+        uint64_t uint64 = 0;
+        double real = 0.0;
+
+        run("converter/parse_int64", [&]() {
+            keep(Options::parse_int64(INTEGER.data(), INTEGER.size(), int64) == Options::Conversion::Ok);
+        });
+        run("converter/parse_uint64/hex", [&]() {
+            keep(Options::parse_uint64(HEX.data(), HEX.size(), uint64) == Options::Conversion::Ok);
+        });
+        run("converter/parse_double", [&]() {
+            keep(Options::parse_double(REAL.data(), REAL.size(), real) == Options::Conversion::Ok);
+        });
+        run("converter/parse_double/long", [&]() {
+            keep(Options::parse_double(LONG_REAL.data(), LONG_REAL.size(), real) == Options::Conversion::Ok);
+        });
+
+        keep(int64 + static_cast<int64_t>(uint64) + (real > 0));
+    }
+
+    void bench_help()
+    {
+        const size_t OPTION_COUNTS[] = {10, 100, 1000};
+
+        for (const size_t option_count: OPTION_COUNTS)
+        {
+            Options::Parser parser;
+            add_options(parser, option_count);
+
+            const std::string suffix = "/" + std::to_string(option_count);
+
+            run("get_possible_options" + suffix, [&]() { keep(parser.get_possible_options().size()); });
+
+            // alternating widths render the text on every call
+            size_t width = 0;
+            run("help/render" + suffix, [&]() {
+                width = (width == 0) ? 100 : 0;
+                keep(parser.write_help(nullptr, 0, width));
+            });
+
+            std::vector<char> buffer(parser.write_help(nullptr, 0) + 1);
+            run("write_help/buffer" + suffix, [&]() { keep(parser.write_help(buffer.data(), buffer.size())); });
+        }
+    }
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+    if (void *result = std::malloc(size != 0 ? size : 1))
+        return result;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+int main(int argc, char *argv[])
+{
+    Options::Parser args_parser;
+
+    args_parser.add_optional("min_time", 't', "Minimal time of every benchmark in milliseconds", "100",
+                             Options::is_double);
+    args_parser.add_optional("filter", 'f', "Run only benchmarks with names containing this text", "");
+    args_parser.add_flag("help", 'h', "Show this help");
+
+    if (!args_parser.parse(argc, argv) || args_parser.as_bool("help"))
+    {
+        printf("Usage: %s [options]\n%s", argv[0], args_parser.get_possible_options().c_str());
+        return args_parser.as_bool("help") ? 0 : -1;
+    }
+
+    settings.min_time_ms = args_parser.as_double("min_time");
+    settings.filter = args_parser.as_string("filter");
+
+    bench_parse();
+    bench_response_file();
+    bench_snapshot();
+    bench_apply();
+    bench_accessors();
+    bench_converters();
+    bench_help();
+
+    return 0;
+}
@@ -1,37 +1,96 @@
 #include <iostream>
 
-#include "options/Converters.hpp"
+#include "options/Option.hpp"
 #include "options/Parser.hpp"
 
+namespace
+{
+    // ids of the choices of the "level" option, in the order they are given to add_choice
+    enum Level
+    {
+        Level_None,
+        Level_Debug,
+        Level_Error
+    };
+
+    const char *describe(int32_t level)
+    {
+        switch (level)
+        {
+            case Level_Debug:
+                return "everything is logged";
+            case Level_Error:
+                return "only errors are logged";
+            default:
+                return "nothing is logged";
+        }
+    }
+} // namespace
+
 int main(int argc, char *argv[])
 {
     Options::Parser args_parser;
 
-    args_parser.add_mandatory("config", 'c', "Configuration file");
-    args_parser.add_optional(
-        "level", "Debug level, one of none, debug, error - it is checked by the validator", "none",
-        [](const std::string &value) { return (value == "none" || value == "debug" || value == "error"); });
+    // the options can be also set in the configuration file, e.g. "level = debug" - the command line wins
+    const auto config = args_parser.add_mandatory("config", 'c', "Configuration file");
+    args_parser.set_config_option(config);
 
+    // the value of a choice is resolved to its id while parsing, invalid ones are rejected
+    const auto level = args_parser.add_choice("level", "Debug level", {"none", "debug", "error"}, "none");
+
+    // ready made validators check the value already converted, without parsing the text again
     args_parser.add_optional("int", 'i', "Some small integer in range <-10..10> as checked by validator", "4",
-                             [](const std::string &value) {
-                                 int32_t num = Options::as_int(value);
-                                 return num >= -10 && num <= 10; // NOLINT
-                             });
-    args_parser.add_optional("double", 'd', "Double value > 3.0", "3.14", [](const std::string &value) {
-        double num = Options::as_double(value);
-        return num > 3.0; // NOLINT
-    });
+                             Options::int_range(-10, 10)); // NOLINT
+    args_parser.add_optional("name", 'n', "Name of a text file", "notes.txt", Options::matches("*.txt"));
+
+    // any other check can be a function or a lambda taking Options::Value, also a capturing one
+    const double minimum = 3.0;
+    args_parser.add_optional("double", 'd', "Double value > 3.0", "3.14",
+                             [minimum](const Options::Value &value) { return value.as_double() > minimum; });
 
     args_parser.add_optional("bf", "Boolean value", "false");
     args_parser.add_optional("bt", "Boolean value", "true");
     args_parser.add_flag("help", 'h', "This help is accessible via short and long option");
     args_parser.add_flag("verbose", 'v', "Verbose - accessible via -v and --verbose");
 
+    // e.g. "source <(./example_full --completion bash)" enables the completion in the current bash session
+    const auto completion = args_parser.add_choice("completion", "Print a completion script for the shell",
+                                                   {"bash", "zsh", "fish"}, "");
+
+    // the completion script queries the program on every completion, so answer it before anything else
+    if (args_parser.complete(argc, argv))
+        return 0;
+
     using std::cout;
     using std::endl;
 
-    if (!args_parser.parse(argc, argv) || args_parser.as_bool("help"))
+    const bool parsed = args_parser.parse(argc, argv);
+
+    // the script is printed without the mandatory options, which nobody gives when installing it
+    const auto missing_only = args_parser.diagnostic().error == Options::Error::Missing_Mandatory;
+    if ((parsed || missing_only) && args_parser.as_choice(completion) != Options::Option::NO_CHOICE)
     {
+        const Options::Shell shells[] = {Options::Shell::Bash, Options::Shell::Zsh, Options::Shell::Fish};
+        cout << Options::completion_script(shells[args_parser.as_choice(completion)], argv[0]);
+        return 0;
+    }
+
+    if (!parsed || args_parser.as_bool("help"))
+    {
+        const auto &diagnostic = args_parser.diagnostic();
+        if (diagnostic)
+        {
+            cout << Options::describe(diagnostic.error) << ": " << diagnostic.token << " " << diagnostic.value;
+            if (diagnostic.option.is_valid() && !args_parser.choices(diagnostic.option).empty())
+            {
+                cout << " (valid are:";
+                for (const auto &choice: args_parser.choices(diagnostic.option))
+                    cout << " " << choice;
+                cout << ")";
+            }
+            cout << endl;
+        }
+
         cout << "Usage: " << argv[0] << " [options] [-- [positional arguments]]" << endl;
         cout << args_parser.get_possible_options() << endl;
         return -1;
@@ -40,8 +99,9 @@ int main(int argc, char *argv[])
     cout << std::boolalpha;
     cout << "Options:" << endl;
     cout << " config  : " << args_parser.as_string("config") << endl;
-    cout << " level   : " << args_parser.as_string("level") << endl;
+    cout << " level   : " << args_parser.as_string(level) << " - " << describe(args_parser.as_choice(level)) << endl;
     cout << " int     : " << args_parser.as_int("int") << endl;
+    cout << " name    : " << args_parser.as_string("name") << endl;
     cout << " double  : " << args_parser.as_double("double") << endl;
     cout << " bf      : " << args_parser.as_bool("bf") << endl;
     cout << " bt      : " << args_parser.as_bool("bt") << endl;
@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <cstring>
+
+#include "Arena.hpp"
+
+namespace Options
+{
+    constexpr size_t Arena::DEFAULT_BLOCK_SIZE;
+
+    Arena::Arena(size_t block_size) : _block_size{block_size} {}
+
+    View Arena::store(View text)
+    {
+        char *data = allocate(text.size() + 1);
+
+        if (!text.empty())
+            memcpy(data, text.data(), text.size());
+        data[text.size()] = '\0';
+
+        return {data, text.size()};
+    }
+
+    void Arena::rewind(const Mark &mark)
+    {
+        _current = mark.block;
+        _used = mark.used;
+        _size = mark.size;
+    }
+
+    char *Arena::allocate(size_t size)
+    {
+        if (_blocks.empty() || _blocks[_current].capacity - _used < size)
+        {
+            if (!_blocks.empty())
+                _current += 1;
+            _used = 0;
+
+            // reuse the next block if it is big enough, otherwise put a new one in front of it
+            if (_current == _blocks.size() || _blocks[_current].capacity < size)
+            {
+                const size_t capacity = std::max(_block_size, size);
+                _blocks.insert(_blocks.begin() + static_cast<std::ptrdiff_t>(_current),
+                               {std::unique_ptr<char[]>(new char[capacity]), capacity});
+            }
+        }
+
+        char *result = _blocks[_current].data.get() + _used;
+        _used += size;
+        _size += size;
+
+        return result;
+    }
+} // namespace Options
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "View.hpp"
+
+namespace Options
+{
+    /* Bump allocator for texts.
+     *
+     * Texts are copied one after another into a few big blocks, so storing many small strings costs
+     * only an occasional allocation of a new block. The blocks never move, so the views returned
+     * stay valid as long as the arena lives.
+     *
+     * The arena can be rewound to a previously taken mark, which discards everything stored after it.
+     * The blocks are kept and reused, so a cycle of storing and rewinding allocates nothing.
+     */
+    class Arena
+    {
+    public:
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 4096;
+
+        explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE);
+
+        Arena(const Arena &) = delete;
+        Arena(Arena &&) = delete;
+        Arena &operator=(const Arena &) = delete;
+        Arena &operator=(Arena &&) = delete;
+
+        // Copies the text into the arena and terminates it with a NUL character.
+        View store(View text);
+
+        // Number of bytes used by the stored texts.
+        size_t size() const { return _size; }
+
+        struct Mark
+        {
+            size_t block;
+            size_t used;
+            size_t size;
+        };
+
+        Mark mark() const { return {_current, _used, _size}; }
+
+        // Discards all the texts stored after the mark was taken - views to them become invalid.
+        void rewind(const Mark &mark);
+
+    private:
+        char *allocate(size_t size);
+
+        struct Block
+        {
+            std::unique_ptr<char[]> data;
+            size_t capacity;
+        };
+
+        size_t _block_size;
+        std::vector<Block> _blocks;
+        size_t _current = 0; // block used for allocations, the following ones are free
+        size_t _used = 0;    // bytes used in the current block
+        size_t _size = 0;    // bytes used in all the blocks
+    };
+} // namespace Options
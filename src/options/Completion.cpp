@@ -0,0 +1,90 @@
+#include <cctype>
+
+#include "Completion.hpp"
+
+namespace Options
+{
+    namespace
+    {
+        // Name usable in a shell function name, like "my_tool" for "my-tool".
+        std::string identifier(const std::string &program)
+        {
+            std::string result;
+
+            for (const char c: program.substr(program.find_last_of('/') + 1))
+                result += (isalnum(static_cast<unsigned char>(c)) != 0) ? c : '_';
+
+            return result;
+        }
+
+        void replace_all(std::string &text, const std::string &from, const std::string &to)
+        {
+            for (size_t position = text.find(from); position != std::string::npos;
+                 position = text.find(from, position + to.size()))
+                text.replace(position, from.size(), to);
+        }
+
+        // Every candidate printed by the program is "text<TAB>description". The words up to the cursor are
+        // passed as separate arguments, the last one (maybe empty) is the one being completed.
+        const char *const BASH_SCRIPT = R"(# bash completion of PROGRAM
+_ID_complete()
+{
+    local line=${COMP_LINE:0:COMP_POINT}
+    local -a words
+    read -r -a words <<< "$line"
+    [[ $line == *[[:space:]] ]] && words+=("")
+
+    local IFS=$'\n'
+    local -a candidates=($("${words[0]}" --__complete "${words[@]:1}" 2>/dev/null))
+    candidates=("${candidates[@]%%$'\t'*}")
+
+    # bash splits words at '=', so a value given as --name=value is completed alone
+    if [[ ${words[${#words[@]}-1]} == *=* ]]; then
+        candidates=("${candidates[@]#*=}")
+        [[ ${COMP_WORDS[COMP_CWORD]} == "=" ]] && candidates=("${candidates[@]/#/=}")
+    fi
+
+    COMPREPLY=("${candidates[@]}")
+}
+complete -o default -F _ID_complete PROGRAM
+)";
+
+        const char *const ZSH_SCRIPT = R"(#compdef PROGRAM
+_ID_complete()
+{
+    local -a candidates
+    candidates=("${(@f)$("${words[1]}" --__complete "${(@)words[2,CURRENT]}" 2>/dev/null)}")
+    candidates=("${(@)candidates//:/\\:}")
+    candidates=("${(@)candidates/$'\t'/:}")
+
+    if (( ${#candidates} )); then
+        _describe -t options 'PROGRAM' candidates
+    else
+        _files
+    fi
+}
+compdef _ID_complete PROGRAM
+)";
+
+        const char *const FISH_SCRIPT = R"(# fish completion of PROGRAM
+function __ID_complete
+    set -l words (commandline -opc)
+    set -l current (commandline -ct)
+    set -l program $words[1]
+    set -e words[1]
+    $program --__complete $words "$current" 2>/dev/null
+end
+complete -c PROGRAM -a '(__ID_complete)'
+)";
+    } // namespace
+
+    std::string completion_script(Shell shell, const std::string &program)
+    {
+        std::string script = (shell == Shell::Bash) ? BASH_SCRIPT : (shell == Shell::Zsh) ? ZSH_SCRIPT : FISH_SCRIPT;
+
+        replace_all(script, "_ID_", "_" + identifier(program) + "_");
+        replace_all(script, "PROGRAM", program.substr(program.find_last_of('/') + 1));
+
+        return script;
+    }
+} // namespace Options
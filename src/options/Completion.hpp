@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+namespace Options
+{
+    enum class Shell
+    {
+        Bash,
+        Zsh,
+        Fish
+    };
+
+    /* Returns a script completing the command line of the program in the shell.
+     *
+     * The script does not list the options itself - on every completion it runs the program with the
+     * words typed so far, "program --__complete word...", and offers what it prints. The program
+     * answers that by Parser::complete before doing anything else, so the script never gets out of
+     * date and completing stays fast even for hundreds of options. Install it e.g. as:
+     *
+     *     program --completion bash > /etc/bash_completion.d/program
+     *
+     * where "--completion" is an option of the program printing this script.
+     */
+    std::string completion_script(Shell shell, const std::string &program);
+} // namespace Options
@@ -0,0 +1,77 @@
+#include <cstring>
+
+#include "Config_File.hpp"
+
+namespace Options
+{
+    namespace
+    {
+        bool is_blank(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+        }
+
+        // Removes white spaces from both ends of [begin, end).
+        void trim(char *&begin, char *&end)
+        {
+            while (begin < end && is_blank(*begin))
+                ++begin;
+
+            while (end > begin && is_blank(end[-1]))
+                --end;
+        }
+    } // namespace
+
+    bool Config_File::next(View &key, View &value)
+    {
+        while (_position < _size && !_malformed)
+        {
+            char *begin = _data + _position;
+            char *end = static_cast<char *>(memchr(begin, '\n', _size - _position));
+            if (end == nullptr)
+                end = _data + _size;
+
+            _position = static_cast<size_t>(end - _data) + 1;
+            _line += 1;
+
+            trim(begin, end);
+
+            if (begin == end || *begin == '#' || *begin == ';')
+                continue;
+
+            char *separator = static_cast<char *>(memchr(begin, '=', static_cast<size_t>(end - begin)));
+
+            char *key_end = (separator != nullptr) ? separator : end;
+            char *value_begin = (separator != nullptr) ? separator + 1 : end;
+            char *value_end = end;
+
+            trim(begin, key_end);
+            trim(value_begin, value_end);
+
+            if (begin == key_end)
+            {
+                _malformed = true;
+                return false;
+            }
+
+            const bool quoted = value_end - value_begin >= 2 && (*value_begin == '"' || *value_begin == '\'') &&
+                                value_end[-1] == *value_begin;
+            if (quoted)
+            {
+                ++value_begin;
+                --value_end;
+            }
+
+            // terminators are written at the end, as they may overwrite the separator
+            *key_end = '\0';
+            *value_end = '\0';
+
+            key = {begin, static_cast<size_t>(key_end - begin)};
+            value = {value_begin, static_cast<size_t>(value_end - value_begin)};
+
+            return true;
+        }
+
+        return false;
+    }
+} // namespace Options
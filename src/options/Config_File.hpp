@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Mapped_File.hpp"
+#include "View.hpp"
+
+namespace Options
+{
+    /* Reader of a configuration file with "key = value" lines.
+     *
+     * The key is the long name of an option. White spaces around keys and values are ignored, a value
+     * can be put in single or double quotes to keep them. A line with only a key has an empty value,
+     * which for a flag means it is set. Empty lines and lines starting with '#' or ';' are skipped.
+     *
+     * Like Response_File it works in place: the keys and values are views into the file terminated
+     * with a NUL character written over the following character. They are valid as long as the file lives.
+     */
+    class Config_File
+    {
+    public:
+        explicit Config_File(Mapped_File &file) : _data{file.data()}, _size{file.size()} {}
+
+        // Reads the next entry. Returns false at the end of the file or at a malformed line.
+        bool next(View &key, View &value);
+
+        // True if reading stopped at a line without a key.
+        bool malformed() const { return _malformed; }
+
+        // Number of the line of the last read entry, starting from 1.
+        size_t line() const { return _line; }
+
+    private:
+        char *_data;
+        size_t _size;
+        size_t _position = 0;
+        size_t _line = 0;
+        bool _malformed = false;
+    };
+} // namespace Options
@@ -1,28 +1,422 @@
 #include <string.h> // strcasecmp
 
+#include <clocale>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
 #include "Converters.hpp"
 
 namespace Options
 {
     int32_t as_int(const std::string &value)
     {
-        constexpr int32_t DEC_BASE = 10;
-        return static_cast<int32_t>(std::strtol(value.c_str(), nullptr, DEC_BASE));
+        return as_int(value.c_str());
     }
 
     uint32_t as_uint(const std::string &value)
     {
-        constexpr int32_t DEC_BASE = 10;
-        return static_cast<uint32_t>(std::strtol(value.c_str(), nullptr, DEC_BASE));
+        return as_uint(value.c_str());
     }
 
     double as_double(const std::string &value)
     {
-        return std::strtod(value.c_str(), nullptr);
+        return as_double(value.c_str());
     }
 
     bool as_bool(const std::string &value)
     {
-        return (strcasecmp("true", value.c_str()) == 0) || (as_int(value) != 0);
+        return as_bool(value.c_str());
+    }
+
+    int32_t as_int(const char *value)
+    {
+        constexpr int32_t DEC_BASE = 10;
+        return static_cast<int32_t>(std::strtol(value, nullptr, DEC_BASE));
+    }
+
+    uint32_t as_uint(const char *value)
+    {
+        constexpr int32_t DEC_BASE = 10;
+        return static_cast<uint32_t>(std::strtol(value, nullptr, DEC_BASE));
+    }
+
+    double as_double(const char *value)
+    {
+        return std::strtod(value, nullptr);
+    }
+
+    bool as_bool(const char *value)
+    {
+        return (strcasecmp("true", value) == 0) || (as_int(value) != 0);
+    }
+
+    namespace
+    {
+        constexpr uint32_t NOT_A_DIGIT = 255;
+
+        uint32_t digit_value(char c)
+        {
+            if (c >= '0' && c <= '9')
+                return static_cast<uint32_t>(c - '0');
+
+            constexpr uint32_t FIRST_LETTER_DIGIT = 10;
+
+            if (c >= 'a' && c <= 'f')
+                return static_cast<uint32_t>(c - 'a') + FIRST_LETTER_DIGIT;
+
+            if (c >= 'A' && c <= 'F')
+                return static_cast<uint32_t>(c - 'A') + FIRST_LETTER_DIGIT;
+
+            return NOT_A_DIGIT;
+        }
+
+        // Returns how many bits a size suffix shifts the value by, or 0 if it is not a size suffix.
+        uint32_t suffix_shift(char c)
+        {
+            switch (c)
+            {
+                case 'k':
+                case 'K':
+                    return 10; // NOLINT
+                case 'm':
+                case 'M':
+                    return 20; // NOLINT
+                case 'g':
+                case 'G':
+                    return 30; // NOLINT
+                case 't':
+                case 'T':
+                    return 40; // NOLINT
+                case 'p':
+                case 'P':
+                    return 50; // NOLINT
+                case 'e':
+                case 'E':
+                    return 60; // NOLINT
+                default:
+                    return 0;
+            }
+        }
+
+        // Converts an unsigned number without a sign, but with an optional base prefix and size suffix.
+        Conversion parse_magnitude(const char *text, const char *end, uint64_t &result)
+        {
+            constexpr uint32_t DEC_BASE = 10;
+            constexpr uint32_t HEX_BASE = 16;
+            constexpr uint32_t OCT_BASE = 8;
+
+            uint32_t base = DEC_BASE;
+            bool has_digits = false;
+
+            if (end - text > 1 && text[0] == '0')
+            {
+                if (text[1] == 'x' || text[1] == 'X')
+                {
+                    base = HEX_BASE;
+                    text += 2;
+                }
+                else
+                {
+                    base = OCT_BASE;
+                    text += 1;
+                    has_digits = true; // the leading zero
+                }
+            }
+
+            uint64_t value = 0;
+
+            for (; text != end; ++text)
+            {
+                const uint32_t digit = digit_value(*text);
+                if (digit >= base)
+                    break;
+
+                if (value > (std::numeric_limits<uint64_t>::max() - digit) / base)
+                    return Conversion::Out_Of_Range;
+
+                value = value * base + digit;
+                has_digits = true;
+            }
+
+            if (!has_digits)
+                return Conversion::Invalid;
+
+            if (text != end)
+            {
+                const uint32_t shift = suffix_shift(*text);
+                if (shift == 0 || text + 1 != end)
+                    return Conversion::Invalid;
+
+                if (value > (std::numeric_limits<uint64_t>::max() >> shift))
+                    return Conversion::Out_Of_Range;
+
+                value <<= shift;
+            }
+
+            result = value;
+            return Conversion::Ok;
+        }
+
+        // Case insensitive comparison of the whole [text, end) range with a lower case word.
+        bool equals_word(const char *text, const char *end, const char *word)
+        {
+            const size_t size = strlen(word);
+
+            if (static_cast<size_t>(end - text) != size)
+                return false;
+
+            for (size_t i = 0; i < size; ++i)
+                if ((text[i] | 0x20) != word[i]) // NOLINT - ascii lower case
+                    return false;
+
+            return true;
+        }
+
+        // Fallback for numbers which cannot be converted exactly by the fast path. The text has been
+        // already validated, so only the decimal point has to be adjusted to what strtod expects.
+        Conversion strtod_in_c_format(const char *text, size_t size, double &result)
+        {
+            const char *decimal_point = std::localeconv()->decimal_point;
+            const size_t decimal_point_size = strlen(decimal_point);
+
+            constexpr size_t BUFFER_SIZE = 128;
+            char local_buffer[BUFFER_SIZE];
+            std::string big_buffer;
+
+            char *buffer = local_buffer;
+            if (size + decimal_point_size >= BUFFER_SIZE)
+            {
+                big_buffer.resize(size + decimal_point_size + 1);
+                buffer = &big_buffer[0];
+            }
+
+            size_t used = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                if (text[i] == '.')
+                {
+                    memcpy(buffer + used, decimal_point, decimal_point_size);
+                    used += decimal_point_size;
+                }
+                else
+                    buffer[used++] = text[i];
+            }
+            buffer[used] = '\0';
+
+            char *parsed_end = nullptr;
+            const double value = std::strtod(buffer, &parsed_end);
+
+            if (parsed_end != buffer + used)
+                return Conversion::Invalid;
+
+            if (std::isinf(value))
+                return Conversion::Out_Of_Range;
+
+            result = value;
+            return Conversion::Ok;
+        }
+    } // namespace
+
+    Conversion parse_uint64(const char *text, size_t size, uint64_t &result)
+    {
+        if (size == 0)
+            return Conversion::Empty;
+
+        const char *end = text + size;
+
+        if (*text == '+')
+            ++text;
+
+        return parse_magnitude(text, end, result);
+    }
+
+    Conversion parse_int64(const char *text, size_t size, int64_t &result)
+    {
+        if (size == 0)
+            return Conversion::Empty;
+
+        const char *end = text + size;
+        const bool negative = (*text == '-');
+
+        if (*text == '+' || *text == '-')
+            ++text;
+
+        uint64_t magnitude = 0;
+        const Conversion status = parse_magnitude(text, end, magnitude);
+
+        if (status != Conversion::Ok)
+            return status;
+
+        constexpr auto MAX = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+
+        if (negative)
+        {
+            if (magnitude > MAX + 1)
+                return Conversion::Out_Of_Range;
+
+            result = (magnitude == MAX + 1) ? std::numeric_limits<int64_t>::min() : -static_cast<int64_t>(magnitude);
+        }
+        else
+        {
+            if (magnitude > MAX)
+                return Conversion::Out_Of_Range;
+
+            result = static_cast<int64_t>(magnitude);
+        }
+
+        return Conversion::Ok;
+    }
+
+    Conversion parse_double(const char *text, size_t size, double &result)
+    {
+        if (size == 0)
+            return Conversion::Empty;
+
+        const char *const begin = text;
+        const char *const end = text + size;
+        const bool negative = (*text == '-');
+
+        if (*text == '+' || *text == '-')
+            ++text;
+
+        if (equals_word(text, end, "inf") || equals_word(text, end, "infinity"))
+        {
+            result = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+            return Conversion::Ok;
+        }
+
+        if (equals_word(text, end, "nan"))
+        {
+            result = std::numeric_limits<double>::quiet_NaN();
+            return Conversion::Ok;
+        }
+
+        // Significant digits are collected into an integer mantissa, so value = mantissa * 10^exponent.
+        constexpr int32_t MAX_MANTISSA_DIGITS = 19;
+        constexpr uint64_t DEC_BASE = 10;
+
+        uint64_t mantissa = 0;
+        int32_t mantissa_digits = 0;
+        int32_t exponent = 0;
+        bool has_digits = false;
+        bool exact = true; // false if some significant digits did not fit into the mantissa
+
+        const auto add_digit = [&](uint32_t digit, bool fractional) {
+            has_digits = true;
+
+            if (mantissa == 0 && digit == 0) // leading zero
+            {
+                if (fractional)
+                    exponent -= 1;
+                return;
+            }
+
+            if (mantissa_digits < MAX_MANTISSA_DIGITS)
+            {
+                mantissa = mantissa * DEC_BASE + digit;
+                mantissa_digits += 1;
+                if (fractional)
+                    exponent -= 1;
+            }
+            else
+            {
+                exact = false;
+                if (!fractional)
+                    exponent += 1;
+            }
+        };
+
+        for (; text != end && *text >= '0' && *text <= '9'; ++text)
+            add_digit(static_cast<uint32_t>(*text - '0'), false);
+
+        if (text != end && *text == '.')
+            for (++text; text != end && *text >= '0' && *text <= '9'; ++text)
+                add_digit(static_cast<uint32_t>(*text - '0'), true);
+
+        if (!has_digits)
+            return Conversion::Invalid;
+
+        if (text != end && (*text == 'e' || *text == 'E'))
+        {
+            ++text;
+
+            const bool negative_exponent = (text != end && *text == '-');
+            if (text != end && (*text == '+' || *text == '-'))
+                ++text;
+
+            if (text == end)
+                return Conversion::Invalid;
+
+            constexpr int32_t EXPONENT_LIMIT = 100000; // far beyond anything a double can represent
+            int32_t explicit_exponent = 0;
+
+            for (; text != end && *text >= '0' && *text <= '9'; ++text)
+                if (explicit_exponent < EXPONENT_LIMIT)
+                    explicit_exponent = explicit_exponent * static_cast<int32_t>(DEC_BASE) + (*text - '0');
+
+            exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+        }
+
+        if (text != end)
+            return Conversion::Invalid;
+
+        // Fast path: both the mantissa and the power of 10 are exactly representable as doubles, so
+        // a single multiplication or division gives a correctly rounded result.
+        static const double POWERS_OF_10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                              1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                              1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        constexpr int32_t MAX_EXACT_POWER = 22;
+        constexpr uint64_t MAX_EXACT_MANTISSA = uint64_t{1} << 53U;
+
+        if (mantissa == 0)
+        {
+            result = negative ? -0.0 : 0.0;
+            return Conversion::Ok;
+        }
+
+        if (exact && mantissa <= MAX_EXACT_MANTISSA && exponent >= -MAX_EXACT_POWER && exponent <= MAX_EXACT_POWER)
+        {
+            auto value = static_cast<double>(mantissa);
+            value = (exponent < 0) ? value / POWERS_OF_10[-exponent] : value * POWERS_OF_10[exponent];
+
+            result = negative ? -value : value;
+            return Conversion::Ok;
+        }
+
+        return strtod_in_c_format(begin, size, result);
+    }
+
+    int64_t as_int64(const std::string &value)
+    {
+        int64_t result = 0;
+        parse_int64(value.data(), value.size(), result);
+        return result;
+    }
+
+    uint64_t as_uint64(const std::string &value)
+    {
+        uint64_t result = 0;
+        parse_uint64(value.data(), value.size(), result);
+        return result;
+    }
+
+    bool is_int64(const std::string &value)
+    {
+        int64_t result = 0;
+        return parse_int64(value.data(), value.size(), result) == Conversion::Ok;
+    }
+
+    bool is_uint64(const std::string &value)
+    {
+        uint64_t result = 0;
+        return parse_uint64(value.data(), value.size(), result) == Conversion::Ok;
+    }
+
+    bool is_double(const std::string &value)
+    {
+        double result = 0.0;
+        return parse_double(value.data(), value.size(), result) == Conversion::Ok;
     }
 } // namespace Options
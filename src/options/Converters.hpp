@@ -1,13 +1,52 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
 namespace Options
 {
+    // Lenient conversions - like strtol/strtod they use the longest valid prefix and return 0 if there is none.
     int32_t as_int(const std::string &value);
     uint32_t as_uint(const std::string &value);
     double as_double(const std::string &value);
     bool as_bool(const std::string &value);
 
+    // The same for NUL-terminated text.
+    int32_t as_int(const char *value);
+    uint32_t as_uint(const char *value);
+    double as_double(const char *value);
+    bool as_bool(const char *value);
+
+    enum class Conversion
+    {
+        Ok,
+        Empty,       // there is nothing to convert
+        Invalid,     // not a number or not only a number (e.g. "12abc")
+        Out_Of_Range // a number, but it does not fit into the type
+    };
+
+    /* Strict conversions of exactly `size` characters starting at `text`.
+     *
+     * They do not allocate, do not depend on the current locale and the whole text must be a number,
+     * otherwise a failure is returned and `result` is left untouched.
+     *
+     * Integers may be given as decimal, hexadecimal (0x1f) or octal (017), optionally followed by
+     * a binary size suffix: k, M, G, T, P or E (case insensitive) - so "4k" is 4096.
+     *
+     * Floating point numbers are decimal with an optional exponent (-1.5e3), or inf/infinity/nan.
+     */
+    Conversion parse_int64(const char *text, size_t size, int64_t &result);
+    Conversion parse_uint64(const char *text, size_t size, uint64_t &result);
+    Conversion parse_double(const char *text, size_t size, double &result);
+
+    // Strict conversions returning 0 when the value is not a valid number.
+    int64_t as_int64(const std::string &value);
+    uint64_t as_uint64(const std::string &value);
+
+    // Checks usable as validators, so invalid numbers are rejected already while parsing.
+    bool is_int64(const std::string &value);
+    bool is_uint64(const std::string &value);
+    bool is_double(const std::string &value);
+
 } // namespace Options
@@ -0,0 +1,41 @@
+#include "Diagnostic.hpp"
+
+namespace Options
+{
+    const char *describe(Error error)
+    {
+        switch (error)
+        {
+            case Error::None:
+                return "no error";
+            case Error::Unknown_Option:
+                return "unknown option";
+            case Error::Ambiguous_Option:
+                return "ambiguous option";
+            case Error::Unexpected_Argument:
+                return "unexpected argument";
+            case Error::Missing_Value:
+                return "missing value";
+            case Error::Invalid_Value:
+                return "invalid value";
+            case Error::Unexpected_Value:
+                return "option does not take a value";
+            case Error::Missing_Mandatory:
+                return "missing mandatory option";
+            case Error::Unknown_Subcommand:
+                return "unknown subcommand";
+            case Error::Unreadable_File:
+                return "cannot read file";
+            case Error::Malformed_Response_File:
+                return "unterminated quote in file";
+            case Error::Malformed_Config_Line:
+                return "malformed line";
+            case Error::Malformed_Snapshot:
+                return "malformed snapshot";
+            case Error::Schema_Mismatch:
+                return "snapshot of different options";
+        }
+
+        return "unknown error";
+    }
+} // namespace Options
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Handle.hpp"
+#include "View.hpp"
+
+namespace Options
+{
+    // Why parsing failed.
+    enum class Error
+    {
+        None,
+        Unknown_Option,          // no option with such a name
+        Ambiguous_Option,        // a prefix of more than one long name
+        Unexpected_Argument,     // not an option, e.g. a positional argument before "--"
+        Missing_Value,           // the last token is an option which takes a value
+        Invalid_Value,           // the value was rejected by the validator of the option
+        Unexpected_Value,        // a value given to a flag, like "--verbose=yes"
+        Missing_Mandatory,       // a mandatory option was not given by any source
+        Unknown_Subcommand,      // no subcommand with such a name
+        Unreadable_File,         // a response or configuration file cannot be read
+        Malformed_Response_File, // a response file with an unterminated quote
+        Malformed_Config_Line,   // a line of a configuration file without a key
+        Malformed_Snapshot,      // a snapshot which is truncated or not a snapshot at all
+        Schema_Mismatch,         // a snapshot saved by a parser with different options
+    };
+
+    // Short description of the error, like "unknown option".
+    const char *describe(Error error);
+
+    /* What went wrong when parsing failed - filled by parse, so the failure can be reported precisely.
+     *
+     * The views refer to copies owned by the result, they stay valid until it is reset. Nothing is
+     * stored (and nothing allocated) while parsing succeeds.
+     */
+    struct Diagnostic
+    {
+        Error error = Error::None;
+        int argv_index = -1; // the failing argument, for a response file the "@path" one, -1 if not from argv
+        size_t line = 0;     // line of a configuration file, 0 if not from a file
+        Handle option;       // the option concerned, if known
+        View token;          // the failing token, config key, environment variable or file path
+        View value;          // the offending value, if any
+
+        explicit operator bool() const { return error != Error::None; }
+    };
+} // namespace Options
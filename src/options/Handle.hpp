@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Options
+{
+    /* Handle to an option registered in a Parser.
+     *
+     * It is returned by the Parser::add_* methods and allows retrieving the value of an option
+     * without looking up its name. It is just an index, so it is cheap to copy and store.
+     *
+     * A default constructed handle refers to no option.
+     */
+    class Handle
+    {
+    public:
+        Handle() = default;
+        explicit Handle(uint32_t index) : _index{index} {}
+
+        uint32_t index() const { return _index; }
+        bool is_valid() const { return _index != INVALID; }
+
+        bool operator==(Handle other) const { return _index == other._index; }
+        bool operator!=(Handle other) const { return _index != other._index; }
+
+        static constexpr uint32_t INVALID = UINT32_MAX;
+
+    private:
+        uint32_t _index = INVALID;
+    };
+} // namespace Options
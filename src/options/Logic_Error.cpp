@@ -0,0 +1,24 @@
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "Logic_Error.hpp"
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+    #define OPTIONS_HAS_EXCEPTIONS 1
+#else
+    #define OPTIONS_HAS_EXCEPTIONS 0
+#endif
+
+namespace Options
+{
+    void throw_logic_error(const std::string &message)
+    {
+#if OPTIONS_HAS_EXCEPTIONS
+        throw std::logic_error(message);
+#else
+        fprintf(stderr, "options: %s\n", message.c_str());
+        abort();
+#endif
+    }
+} // namespace Options
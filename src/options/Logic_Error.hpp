@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+
+namespace Options
+{
+    // Reports a misuse of the library, like an unknown option name. Throws std::logic_error, or when built
+    // without exceptions (-fno-exceptions) prints the message and aborts.
+    [[noreturn]] void throw_logic_error(const std::string &message);
+} // namespace Options
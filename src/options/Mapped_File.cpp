@@ -0,0 +1,86 @@
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define OPTIONS_USE_MMAP 1
+#endif
+
+#include "Mapped_File.hpp"
+
+namespace Options
+{
+    Mapped_File::~Mapped_File()
+    {
+#if defined(OPTIONS_USE_MMAP)
+        if (_mapped_size > 0)
+            munmap(_data, _mapped_size);
+#endif
+    }
+
+    bool Mapped_File::open(const char *path)
+    {
+#if defined(OPTIONS_USE_MMAP)
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        bool result = fstat(fd, &info) == 0;
+
+        if (result && info.st_size > 0)
+        {
+            const auto size = static_cast<size_t>(info.st_size);
+
+            // Reserve one byte more than the file, then map the file over the beginning. The byte after the
+            // contents is then either in the zero-filled tail of the last page of the file or in the reserved
+            // anonymous page - writable in both cases.
+            void *data = mmap(nullptr, size + 1, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            result = data != MAP_FAILED;
+
+            if (result && mmap(data, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+            {
+                munmap(data, size + 1);
+                result = false;
+            }
+
+            if (result)
+            {
+                madvise(data, size, MADV_SEQUENTIAL);
+                _data = static_cast<char *>(data);
+                _size = size;
+                _mapped_size = size + 1;
+            }
+        }
+
+        close(fd);
+        return result;
+#else
+        FILE *file = fopen(path, "rb");
+        if (file == nullptr)
+            return false;
+
+        bool result = fseek(file, 0, SEEK_END) == 0;
+        const long size = result ? ftell(file) : -1;
+        result = result && size >= 0 && fseek(file, 0, SEEK_SET) == 0;
+
+        if (result && size > 0)
+        {
+            _buffer.reset(new char[static_cast<size_t>(size) + 1]);
+            result = fread(_buffer.get(), 1, static_cast<size_t>(size), file) == static_cast<size_t>(size);
+
+            if (result)
+            {
+                _data = _buffer.get();
+                _size = static_cast<size_t>(size);
+                _data[_size] = '\0';
+            }
+        }
+
+        fclose(file);
+        return result;
+#endif
+    }
+} // namespace Options
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace Options
+{
+    /* Contents of a file mapped privately into memory.
+     *
+     * The contents can be modified in place - the changes are never written back to the file. There
+     * is always one more writable byte after the contents set to NUL, so the last line or token of
+     * a file can be terminated in place as well.
+     *
+     * Where memory mapping is not available, the file is read into a single buffer instead.
+     */
+    class Mapped_File
+    {
+    public:
+        Mapped_File() = default;
+        ~Mapped_File();
+
+        Mapped_File(const Mapped_File &) = delete;
+        Mapped_File(Mapped_File &&) = delete;
+        Mapped_File &operator=(const Mapped_File &) = delete;
+        Mapped_File &operator=(Mapped_File &&) = delete;
+
+        // Returns false if the file cannot be read.
+        bool open(const char *path);
+
+        char *data() { return _data; }
+        size_t size() const { return _size; }
+
+    private:
+        char _empty[1] = {'\0'}; // contents of an empty file
+        char *_data = _empty;
+        size_t _size = 0;
+        size_t _mapped_size = 0;
+        std::unique_ptr<char[]> _buffer; // used when mapping is not available
+    };
+} // namespace Options
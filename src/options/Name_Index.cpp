@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <cstring>
+
+#include "Name_Index.hpp"
+
+namespace Options
+{
+    constexpr uint32_t Name_Index::NOT_FOUND;
+
+    Name_Index::Name_Index()
+    {
+        clear();
+    }
+
+    bool Name_Index::add_long(const char *name, size_t size, uint32_t position)
+    {
+        // keep the load factor at most 1/2, so probing sequences stay short
+        if ((_used + 1) * 2 > _slots.size())
+            grow();
+
+        const uint32_t name_hash = hash(name, size);
+        Slot &slot = _slots[probe(name, size, name_hash)];
+
+        if (slot.position != NOT_FOUND)
+            return false;
+
+        slot.hash = name_hash;
+        slot.key_offset = static_cast<uint32_t>(_keys.size());
+        slot.key_size = static_cast<uint32_t>(size);
+        slot.position = position;
+        _keys.append(name, size);
+        _used += 1;
+
+        return true;
+    }
+
+    bool Name_Index::add_short(char name, uint32_t position)
+    {
+        uint32_t &entry = _short[static_cast<unsigned char>(name)];
+
+        if (entry != NOT_FOUND)
+            return false;
+
+        entry = position;
+        return true;
+    }
+
+    uint32_t Name_Index::find_long(const char *name, size_t size) const
+    {
+        if (_used == 0)
+            return NOT_FOUND;
+
+        return _slots[probe(name, size, hash(name, size))].position;
+    }
+
+    void Name_Index::clear()
+    {
+        std::fill(std::begin(_short), std::end(_short), NOT_FOUND);
+        _slots.clear();
+        _used = 0;
+        _keys.clear();
+    }
+
+    uint32_t Name_Index::hash(const char *name, size_t size)
+    {
+        // FNV-1a
+        constexpr uint32_t OFFSET_BASIS = 2166136261U;
+        constexpr uint32_t PRIME = 16777619U;
+
+        uint32_t result = OFFSET_BASIS;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            result ^= static_cast<unsigned char>(name[i]);
+            result *= PRIME;
+        }
+
+        return result;
+    }
+
+    size_t Name_Index::probe(const char *name, size_t size, uint32_t name_hash) const
+    {
+        const size_t mask = _slots.size() - 1;
+
+        for (size_t pos = name_hash & mask;; pos = (pos + 1) & mask)
+        {
+            const Slot &slot = _slots[pos];
+
+            if (slot.position == NOT_FOUND)
+                return pos;
+
+            if (slot.hash == name_hash && slot.key_size == size &&
+                std::memcmp(_keys.data() + slot.key_offset, name, size) == 0)
+                return pos;
+        }
+    }
+
+    void Name_Index::grow()
+    {
+        constexpr size_t MIN_SLOTS = 16;
+
+        std::vector<Slot> old_slots(std::max(MIN_SLOTS, _slots.size() * 2));
+        old_slots.swap(_slots);
+
+        const size_t mask = _slots.size() - 1;
+
+        for (const auto &slot: old_slots)
+        {
+            if (slot.position == NOT_FOUND)
+                continue;
+
+            size_t pos = slot.hash & mask;
+            while (_slots[pos].position != NOT_FOUND)
+                pos = (pos + 1) & mask;
+
+            _slots[pos] = slot;
+        }
+    }
+} // namespace Options
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Options
+{
+    /* Lookup table from option names to their positions in the option table.
+     *
+     * Short names are resolved through a direct 256-entry table indexed by the character itself.
+     * Long names are kept in an open addressing hash table (linear probing) which owns a copy of
+     * every key, so a lookup needs neither a std::string nor any allocation.
+     *
+     * When a name is added twice, the first registration wins - just like a linear search would.
+     */
+    class Name_Index
+    {
+    public:
+        static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+        Name_Index();
+
+        // Registers a long name for the given position. Returns false if the name was already known.
+        bool add_long(const char *name, size_t size, uint32_t position);
+
+        // Registers a short name for the given position. Returns false if the name was already known.
+        bool add_short(char name, uint32_t position);
+
+        uint32_t find_long(const char *name, size_t size) const;
+        uint32_t find_short(char name) const { return _short[static_cast<unsigned char>(name)]; }
+
+        bool empty() const { return _used == 0; }
+
+        void clear();
+
+    private:
+        struct Slot
+        {
+            uint32_t hash = 0;
+            uint32_t key_offset = 0;
+            uint32_t key_size = 0;
+            uint32_t position = NOT_FOUND;
+        };
+
+        static uint32_t hash(const char *name, size_t size);
+
+        // Returns the slot holding the name or the empty slot where it would be inserted.
+        size_t probe(const char *name, size_t size, uint32_t name_hash) const;
+        void grow();
+
+        static constexpr size_t SHORT_COUNT = 256;
+
+        uint32_t _short[SHORT_COUNT];
+        std::vector<Slot> _slots; // size is always a power of 2
+        uint32_t _used = 0;
+        std::string _keys; // all the long names one after another
+    };
+} // namespace Options
@@ -1,16 +1,47 @@
+#include <utility>
+#include <vector>
+
+#include "Arena.hpp"
+#include "Name_Index.hpp"
 #include "Option.hpp"
-#include "Converters.hpp"
 
 namespace Options
 {
-    Option::Option(const std::string &long_name, char short_name, const std::string &description)
-        : _short_name{short_name}, _long_name{long_name}, _description{description}
+    const char Option::SHORT_NOT_USED;
+    const char Option::SEPARATOR_NOT_USED;
+    const int32_t Option::NO_CHOICE;
+
+    struct Option::Choices
+    {
+        std::vector<View> names;
+        Name_Index index;
+    };
+
+    Option::Option(View long_name, char short_name, View description)
+        : Option(std::make_shared<Arena>(), long_name, short_name, description)
+    {
+    }
+
+    Option::Option(View long_name, View description) : Option(long_name, SHORT_NOT_USED, description) {}
+
+    Option::Option(std::shared_ptr<Arena> arena, View long_name, char short_name, View description)
+        : _arena{std::move(arena)}, _short_name{short_name}
     {
+        _long_name = _arena->store(long_name);
+        _description = _arena->store(description);
     }
 
-    Option::Option(const std::string &long_name, const std::string &description)
-        : Option(long_name, SHORT_NOT_USED, description)
+    Option::Option(std::shared_ptr<Arena> arena, const Option &other)
+        : Option(std::move(arena), other._long_name, other._short_name, other._description)
     {
+        _validator = other._validator;
+        _value_validator = other._value_validator;
+        _type = other._type;
+        _multiple = other._multiple;
+        _separator = other._separator;
+        if (other._choices)
+            assign_choices(other._choices->names.data(), other._choices->names.data() + other._choices->names.size());
+        _default_value.assign(_arena->store(other._default_value.as_string()));
     }
 
     Option &Option::set_mandatory()
@@ -19,67 +50,113 @@ namespace Options
         return *this;
     }
 
-    Option &Option::set_optional(const std::string &default_value)
+    Option &Option::set_optional(View default_value)
     {
         _type = Type::Optional;
-        _default_value = default_value;
+        _default_value.assign(_arena->store(default_value));
         return *this;
     }
 
-    Option &Option::set_validator(validator_t validator)
+    Option &Option::set_multiple(char separator)
     {
-        _validator = validator;
+        _type = Type::Optional;
+        _multiple = true;
+        _separator = separator;
         return *this;
     }
 
-    bool Option::set_value(const std::string &value)
+    Option &Option::set_choices(std::initializer_list<const char *> choices)
     {
-        if (has_argument() && _validator != nullptr)
-            if (!_validator(value))
-                return false;
+        std::vector<View> names(choices.begin(), choices.end());
+        assign_choices(names.data(), names.data() + names.size());
+        return *this;
+    }
 
-        _was_set = true;
-        _value = value;
-        return true;
+    void Option::assign_choices(const View *begin, const View *end)
+    {
+        std::shared_ptr<Choices> choices = std::make_shared<Choices>();
+
+        for (const View *name = begin; name != end; ++name)
+        {
+            const auto id = static_cast<uint32_t>(choices->names.size());
+
+            // a repeated choice keeps the first id
+            if (choices->index.add_long(name->data(), name->size(), id))
+                choices->names.push_back(_arena->store(*name));
+        }
+
+        _choices = std::move(choices);
     }
 
-    int32_t Option::as_int() const
+    int32_t Option::find_choice(View text) const
     {
-        if (was_set())
-            return Options::as_int(_value);
+        if (!_choices)
+            return NO_CHOICE;
 
-        return Options::as_int(_default_value);
+        const uint32_t id = _choices->index.find_long(text.data(), text.size());
+        return (id == Name_Index::NOT_FOUND) ? NO_CHOICE : static_cast<int32_t>(id);
     }
 
-    uint32_t Option::as_uint() const
+    Range<View> Option::choices() const
     {
-        if (was_set())
-            return Options::as_uint(_value);
+        if (!_choices)
+            return {};
 
-        return Options::as_uint(_default_value);
+        return {_choices->names.data(), _choices->names.size()};
     }
 
-    double Option::as_double() const
+    Option &Option::set_validator(validator_t validator)
     {
-        if (was_set())
-            return Options::as_double(_value);
+        _validator = validator;
+        return *this;
+    }
+
+    Option &Option::set_validator(Validator validator)
+    {
+        _value_validator = std::move(validator);
+        return *this;
+    }
 
-        return Options::as_double(_default_value);
+    bool Option::set_value(View value)
+    {
+        return store(value, true);
     }
 
-    bool Option::as_bool() const
+    bool Option::refer_value(View value)
     {
-        if (was_set())
-            return Options::as_bool(_value);
+        return store(value, false);
+    }
 
-        return Options::as_bool(_default_value);
+    void Option::reset()
+    {
+        _was_set = false;
+        _value = Value();
     }
 
-    const std::string &Option::as_string() const
+    bool Option::accepts(const Value &value) const
     {
-        if (was_set())
-            return _value;
+        if (!has_argument())
+            return true;
 
-        return _default_value;
+        if (_validator != nullptr && !_validator(value.as_string().str()))
+            return false;
+
+        return _value_validator(value);
+    }
+
+    bool Option::store(View value, bool copy)
+    {
+        // a copy is made before validation, as the conversions need a NUL-terminated text
+        if (copy)
+            value = _arena->store(value);
+
+        Value converted{value};
+
+        if (!accepts(converted) || (is_choice() && find_choice(value) == NO_CHOICE))
+            return false;
+
+        _was_set = true;
+        _value = converted;
+        return true;
     }
 } // namespace Options
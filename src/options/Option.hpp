@@ -1,12 +1,16 @@
 #pragma once
 
 #include <cstdint>
-#include <string>
+#include <initializer_list>
+#include <memory>
 
+#include "Range.hpp"
 #include "Validator.hpp"
 
 namespace Options
 {
+    class Arena;
+
     /* Single Option representation.
      *
      * An option can be either:
@@ -16,47 +20,96 @@ namespace Options
      *
      * A validator can be set which act as a filter regarding acceptable values.
      *
-     * A value can be retrieved as int, uint, double, bool or string (which is the default type).
+     * An optional option can also take multiple values - see set_multiple - or be restricted to a set of
+     * choices, which are identified by small integer ids - see set_choices.
+     *
+     * A value can be retrieved as int, uint, int64, uint64, double, bool or string (which is the default type).
+     * Both the value and the default are converted once, when they are set, so retrieving them is cheap.
+     *
+     * All the texts (names, description, default and copied values) are stored in an Arena. Options
+     * created by a Parser share the arena of the parser, a standalone option creates its own.
      */
     class Option
     {
     public:
         // Creates an option with both a long and short name.
-        Option(const std::string &long_name, char short_name, const std::string &description);
+        Option(View long_name, char short_name, View description);
 
         // Creates an option with only a long name.
-        Option(const std::string &long_name, const std::string &description);
+        Option(View long_name, View description);
+
+        // Creates an option storing its texts in the given arena.
+        Option(std::shared_ptr<Arena> arena, View long_name, char short_name, View description);
+
+        // Creates a copy of the other option (without its value) storing its texts in the given arena.
+        Option(std::shared_ptr<Arena> arena, const Option &other);
 
         // Mark the option as mandatory.
         Option &set_mandatory();
 
         // Mark the option as optional and set the default value.
-        Option &set_optional(const std::string &default_value);
+        Option &set_optional(View default_value);
+
+        // Mark the option as taking many values, given by repeating it and/or as a list separated by the
+        // separator (unless it is SEPARATOR_NOT_USED). The values are collected by a Parser - set_value of
+        // a standalone option keeps only the last value.
+        Option &set_multiple(char separator);
 
-        // Set a validator for the option.
+        // Restrict the values to the given choices. The id of a choice is its position in the list, so
+        // code using the option can switch on integers instead of comparing strings.
+        Option &set_choices(std::initializer_list<const char *> choices);
+
+        // Set a validator for the option - of the text or of the converted value (see Validator).
         Option &set_validator(validator_t validator);
+        Option &set_validator(Validator validator);
 
         // Sets the value of an option, validates it if necessary, and returns a success status.
-        bool set_value(const std::string &value);
+        // The value is copied into the arena of the option.
+        bool set_value(View value);
+
+        // Like set_value, but the value is not copied - it must be NUL-terminated and outlive the option.
+        bool refer_value(View value);
+
+        // Forgets the value, so the option is not set anymore.
+        void reset();
+
+        // Returns true if the validators of the option accept the value. It does not modify the option.
+        // The choices are not checked - find_choice does that.
+        bool accepts(const Value &value) const;
+
+        // Returns the id of the choice or NO_CHOICE, which is also returned for an option without choices.
+        int32_t find_choice(View text) const;
 
         char short_name() const { return _short_name; }
-        const std::string &long_name() const { return _long_name; }
-        const std::string &description() const { return _description; }
-        const std::string &default_value() const { return _default_value; }
+        View long_name() const { return _long_name; }
+        View description() const { return _description; }
+        View default_value() const { return _default_value.as_string(); }
 
         bool is_flag() const { return _type == Type::Flag; }
         bool is_mandatory() const { return _type == Type::Mandatory; }
         bool is_optional() const { return _type == Type::Optional; }
         bool has_argument() const { return is_mandatory() || is_optional(); }
+        bool is_multiple() const { return _multiple; }
+        bool is_choice() const { return _choices != nullptr; }
+        Range<View> choices() const;
+        char separator() const { return _separator; }
         bool was_set() const { return _was_set; }
 
-        int32_t as_int() const;
-        uint32_t as_uint() const;
-        double as_double() const;
-        bool as_bool() const;
-        const std::string &as_string() const;
+        int32_t as_int() const { return current().as_int(); }
+        uint32_t as_uint() const { return current().as_uint(); }
+        int64_t as_int64() const { return current().as_int64(); }
+        uint64_t as_uint64() const { return current().as_uint64(); }
+        double as_double() const { return current().as_double(); }
+        bool as_bool() const { return current().as_bool(); }
+        std::string as_string() const { return as_view().str(); }
+        View as_view() const { return current().as_string(); }
+        int32_t as_choice() const { return find_choice(as_view()); }
 
-        static constexpr char SHORT_NOT_USED = 0;
+        // Defined in Option.cpp. They are const rather than constexpr, which would make them inline variables
+        // in C++17 code, clashing with the definitions in the library built as C++11.
+        static const char SHORT_NOT_USED = 0;
+        static const char SEPARATOR_NOT_USED = 0;
+        static const int32_t NO_CHOICE = -1;
 
     private:
         enum class Type
@@ -66,14 +119,27 @@ namespace Options
             Mandatory // takes mandatory parameter - no default
         };
 
+        struct Choices; // names and their lookup table, shared by copies of the option
+
+        std::shared_ptr<Arena> _arena;
         char _short_name = SHORT_NOT_USED;
-        std::string _long_name;
-        std::string _description;
+        View _long_name;
+        View _description;
         validator_t _validator = nullptr;
+        Validator _value_validator;
         Type _type = Type::Flag;
-        std::string _default_value;
+        bool _multiple = false;
+        char _separator = SEPARATOR_NOT_USED;
+        std::shared_ptr<const Choices> _choices;
+        Value _default_value;
 
         bool _was_set = false;
-        std::string _value;
+        Value _value;
+
+        bool store(View value, bool copy);
+
+        void assign_choices(const View *begin, const View *end);
+
+        const Value &current() const { return _was_set ? _value : _default_value; }
     };
 } // namespace Options
@@ -0,0 +1,198 @@
+#include "Arena.hpp"
+#include "Logic_Error.hpp"
+#include "Mapped_File.hpp"
+#include "Parse_Result.hpp"
+#include "Parser.hpp"
+#include "Snapshot.hpp"
+
+namespace Options
+{
+    constexpr uint32_t Parse_Result::NO_LIST;
+    constexpr uint64_t Parse_Result::DEFAULT_FINGERPRINT;
+
+    Parse_Result::Parse_Result() : _arena(new Arena) {}
+
+    Parse_Result::~Parse_Result() {}
+
+    Parse_Result::Parse_Result(Parse_Result &&other) noexcept = default;
+
+    Parse_Result &Parse_Result::operator=(Parse_Result &&other) noexcept = default;
+
+    void Parse_Result::reset()
+    {
+        for (size_t i = 0; i < _slots.size(); ++i)
+        {
+            // only a value which differs from the default changes, an update counts the changes at its end
+            const Slot &slot = _slots[i];
+            const View default_text = (*_defaults)[i].value.as_string();
+
+            const bool is_default =
+                (slot.list != NO_LIST) ? _lists[slot.list].strings.empty() : slot.value.as_string() == default_text;
+
+            if (!is_default && !_updating)
+                changed(i);
+
+            _slots[i] = (*_defaults)[i];
+        }
+
+        for (auto &values: _lists)
+            values.clear();
+
+        _positional.clear();
+        _files.clear();
+
+        _diagnostic = Diagnostic();
+        _subcommand_name = View();
+        if (_subcommand)
+            _subcommand->reset();
+        if (_arena) // not moved from
+            _arena->rewind({});
+    }
+
+    void Parse_Result::begin_update()
+    {
+        _fingerprints.resize(_slots.size());
+        for (size_t i = 0; i < _slots.size(); ++i)
+            _fingerprints[i] = fingerprint(i);
+
+        _updating = true;
+        if (_subcommand)
+            _subcommand->begin_update();
+    }
+
+    void Parse_Result::end_update()
+    {
+        _updating = false;
+
+        // a result bound to another parser meanwhile counted all its options as changed already
+        for (size_t i = 0; i < _slots.size() && i < _fingerprints.size(); ++i)
+            if (fingerprint(i) != _fingerprints[i])
+                changed(i);
+
+        if (_subcommand)
+            _subcommand->end_update();
+    }
+
+    uint64_t Parse_Result::fingerprint(size_t position) const
+    {
+        // most of the options keep their defaults, which need no hashing
+        const Slot &slot = _slots[position];
+        if (slot.source == Source::Default)
+            return DEFAULT_FINGERPRINT;
+
+        Fingerprint hash;
+
+        if (slot.list == NO_LIST)
+        {
+            if (slot.value.as_string() == (*_defaults)[position].value.as_string())
+                return DEFAULT_FINGERPRINT;
+
+            hash.add(slot.value.as_string());
+            return hash.value();
+        }
+
+        const auto &strings = _lists[slot.list].strings;
+        if (strings.empty())
+            return DEFAULT_FINGERPRINT;
+
+        hash.add(static_cast<uint64_t>(strings.size()));
+        for (const View text: strings)
+            hash.add(text);
+
+        return hash.value();
+    }
+
+    const Parse_Result &Parse_Result::subcommand_result() const
+    {
+        if (_subcommand_name.empty() || !_subcommand)
+            throw_logic_error("no subcommand was selected");
+
+        return *_subcommand;
+    }
+
+    template <typename T>
+    bool Parse_Result::try_get(const std::string &name, T &value, T (Value::*convert)() const) const
+    {
+        const Slot *found = find_slot(name);
+
+        if (found == nullptr)
+            return false;
+
+        value = (found->value.*convert)();
+        return true;
+    }
+
+    View Parse_Result::positional_view(size_t idx) const
+    {
+        if (idx >= _positional.size())
+            throw_logic_error("positional argument " + std::to_string(idx) + " out of range");
+
+        return _positional[idx];
+    }
+
+    bool Parse_Result::try_get(const std::string &name, int32_t &value) const
+    {
+        return try_get(name, value, &Value::as_int);
+    }
+
+    bool Parse_Result::try_get(const std::string &name, uint32_t &value) const
+    {
+        return try_get(name, value, &Value::as_uint);
+    }
+
+    bool Parse_Result::try_get(const std::string &name, int64_t &value) const
+    {
+        return try_get(name, value, &Value::as_int64);
+    }
+
+    bool Parse_Result::try_get(const std::string &name, uint64_t &value) const
+    {
+        return try_get(name, value, &Value::as_uint64);
+    }
+
+    bool Parse_Result::try_get(const std::string &name, double &value) const
+    {
+        return try_get(name, value, &Value::as_double);
+    }
+
+    bool Parse_Result::try_get(const std::string &name, bool &value) const
+    {
+        return try_get(name, value, &Value::as_bool);
+    }
+
+    bool Parse_Result::try_get(const std::string &name, View &value) const
+    {
+        return try_get(name, value, &Value::as_string);
+    }
+
+    void Parse_Result::List::clear()
+    {
+        strings.clear();
+        int64s.clear();
+        doubles.clear();
+    }
+
+    const Parse_Result::List &Parse_Result::list(const Slot &slot) const
+    {
+        static const List EMPTY;
+
+        return (slot.list == NO_LIST) ? EMPTY : _lists[slot.list];
+    }
+
+    const Parse_Result::Slot &Parse_Result::slot(const std::string &name) const
+    {
+        const Slot *found = find_slot(name);
+
+        if (found == nullptr)
+            throw_logic_error("option '" + name + "' not found");
+
+        return *found;
+    }
+
+    const Parse_Result::Slot *Parse_Result::find_slot(const std::string &name) const
+    {
+        const Handle handle = (_parser != nullptr) ? _parser->find(name) : Handle();
+
+        return handle.is_valid() ? &_slots[handle.index()] : nullptr;
+    }
+} // namespace Options
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Diagnostic.hpp"
+#include "Handle.hpp"
+#include "Range.hpp"
+#include "Value.hpp"
+#include "View.hpp"
+
+namespace Options
+{
+    class Arena;
+    class Mapped_File;
+    class Parser;
+
+    // Where a value of an option comes from. A value from a source with a lower precedence never
+    // replaces a value from a source with a higher one, so the sources can be read in any order.
+    enum class Source
+    {
+        Default,     // not set at all
+        Config,      // configuration file
+        Environment, // environment variable
+        Command_Line // argv or a response file
+    };
+
+    /* Results of parsing a command line - values of options and positional arguments.
+     *
+     * The parser holds only the definitions of options (the schema), a result holds everything a
+     * single parse produces. A frozen parser can parse into many results at the same time from many
+     * threads, as the parser itself is not modified. A result can be moved, e.g. to another thread.
+     *
+     * A result refers to the parser it was filled by (names, defaults), so it must not outlive it.
+     * Not set options have their default values. Accessors work like the ones of the Parser.
+     *
+     * Parsing into a result replaces what is already there, so a result can be reused for every command
+     * line, keeping its memory. Only Parser::parse_config and Parser::apply add to the current values.
+     *
+     * When parsing fails, diagnostic tells why and where. The try_get accessors report an unknown name
+     * by returning false instead of throwing.
+     */
+    class Parse_Result
+    {
+    public:
+        Parse_Result();
+        ~Parse_Result();
+
+        Parse_Result(Parse_Result &&other) noexcept;
+        Parse_Result &operator=(Parse_Result &&other) noexcept;
+
+        Parse_Result(const Parse_Result &) = delete;
+        Parse_Result &operator=(const Parse_Result &) = delete;
+
+        // Forgets the values and positional arguments, keeping the reserved memory.
+        void reset();
+
+        bool was_set(Handle handle) const { return source(handle) != Source::Default; }
+        bool was_set(const std::string &name) const { return source(name) != Source::Default; }
+
+        Source source(Handle handle) const { return _slots[handle.index()].source; }
+        Source source(const std::string &name) const { return slot(name).source; }
+
+        // Number of times the value of the option changed - by parsing, Parser::apply, loading a snapshot or
+        // reset. State derived from an option needs rebuilding only when its version differs from the one it
+        // was built for. Setting an option to the value it already has does not change its version.
+        uint64_t version(Handle handle) const { return _versions[handle.index()]; }
+        uint64_t version(const std::string &name) const
+        {
+            return _versions[static_cast<size_t>(&slot(name) - _slots.data())];
+        }
+
+        // Number of changes of all the options, so a single comparison tells whether anything changed.
+        uint64_t generation() const { return _generation; }
+
+        // Why the last parse failed, Error::None if it did not.
+        const Diagnostic &diagnostic() const { return _diagnostic; }
+
+        // Name of the selected subcommand, or empty if there was none.
+        View subcommand() const { return _subcommand_name; }
+
+        // Values of the options of the selected subcommand. Throws if there was none.
+        const Parse_Result &subcommand_result() const;
+
+        size_t positional_count() const { return _positional.size(); }
+        std::string positional(size_t idx) const { return positional_view(idx).str(); }
+        View positional_view(size_t idx) const;
+        Range<View> positionals() const { return {_positional.data(), _positional.size()}; }
+
+        int32_t as_int(const std::string &name) const { return slot(name).value.as_int(); }
+        uint32_t as_uint(const std::string &name) const { return slot(name).value.as_uint(); }
+        int64_t as_int64(const std::string &name) const { return slot(name).value.as_int64(); }
+        uint64_t as_uint64(const std::string &name) const { return slot(name).value.as_uint64(); }
+        double as_double(const std::string &name) const { return slot(name).value.as_double(); }
+        bool as_bool(const std::string &name) const { return slot(name).value.as_bool(); }
+        std::string as_string(const std::string &name) const { return as_view(name).str(); }
+
+        // Id of the choice of an option added by Parser::add_choice, resolved once while parsing.
+        // Option::NO_CHOICE (-1) for other options and for a default which is not one of the choices.
+        int32_t as_choice(const std::string &name) const { return slot(name).choice; }
+
+        // Set the value and return true, or return false if there is no such option.
+        bool try_get(const std::string &name, int32_t &value) const;
+        bool try_get(const std::string &name, uint32_t &value) const;
+        bool try_get(const std::string &name, int64_t &value) const;
+        bool try_get(const std::string &name, uint64_t &value) const;
+        bool try_get(const std::string &name, double &value) const;
+        bool try_get(const std::string &name, bool &value) const;
+        bool try_get(const std::string &name, View &value) const;
+
+        int32_t as_int(Handle handle) const { return _slots[handle.index()].value.as_int(); }
+        uint32_t as_uint(Handle handle) const { return _slots[handle.index()].value.as_uint(); }
+        int64_t as_int64(Handle handle) const { return _slots[handle.index()].value.as_int64(); }
+        uint64_t as_uint64(Handle handle) const { return _slots[handle.index()].value.as_uint64(); }
+        double as_double(Handle handle) const { return _slots[handle.index()].value.as_double(); }
+        bool as_bool(Handle handle) const { return _slots[handle.index()].value.as_bool(); }
+        std::string as_string(Handle handle) const { return as_view(handle).str(); }
+        int32_t as_choice(Handle handle) const { return _slots[handle.index()].choice; }
+
+        // The texts without copying them. They refer to argv (in zero-copy mode) or to the memory of the result,
+        // so they are valid until the next parse.
+        View as_view(const std::string &name) const { return slot(name).value.as_string(); }
+        View as_view(Handle handle) const { return _slots[handle.index()].value.as_string(); }
+
+        // All the values of a multi-valued option, converted once when they were given. Every range has
+        // one element per value. For other options the ranges are empty.
+        Range<View> as_strings(const std::string &name) const { return to_range(list(slot(name)).strings); }
+        Range<int64_t> as_int64s(const std::string &name) const { return to_range(list(slot(name)).int64s); }
+        Range<double> as_doubles(const std::string &name) const { return to_range(list(slot(name)).doubles); }
+
+        Range<View> as_strings(Handle handle) const { return to_range(list(_slots[handle.index()]).strings); }
+        Range<int64_t> as_int64s(Handle handle) const { return to_range(list(_slots[handle.index()]).int64s); }
+        Range<double> as_doubles(Handle handle) const { return to_range(list(_slots[handle.index()]).doubles); }
+
+    private:
+        friend class Parser;
+
+        static constexpr uint32_t NO_LIST = UINT32_MAX;
+        static constexpr uint64_t DEFAULT_FINGERPRINT = 0; // of a value equal to the default
+
+        struct Slot
+        {
+            Value value; // the last one for a multi-valued option
+            Source source;
+            uint32_t list;  // position in _lists for a multi-valued option, NO_LIST otherwise
+            int32_t choice; // id of the choice of the value, Option::NO_CHOICE if it is not one
+        };
+
+        // values of a multi-valued option
+        struct List
+        {
+            std::vector<View> strings;
+            std::vector<int64_t> int64s;
+            std::vector<double> doubles;
+
+            void clear();
+        };
+
+        // the value of an option before Parser::apply changed it, to roll back an apply which failed
+        struct Change
+        {
+            uint32_t position;
+            Slot slot;
+            List list; // the previous values of a multi-valued option, moved out of _lists
+        };
+
+        // This will throw an exception if the option is not found.
+        const Slot &slot(const std::string &name) const;
+
+        // Returns nullptr if the option is not found.
+        const Slot *find_slot(const std::string &name) const;
+
+        template <typename T>
+        bool try_get(const std::string &name, T &value, T (Value::*convert)() const) const;
+
+        // Counts a change of the value of the option.
+        void changed(size_t position)
+        {
+            ++_versions[position];
+            ++_generation;
+        }
+
+        // While a parse replaces all the values (also of the subcommand), the changes are not counted one by
+        // one. end_update counts the options whose values differ from the ones begin_update saw instead, so
+        // parsing the same command line again changes no version.
+        void begin_update();
+        void end_update();
+
+        // Hash of the value (or of all the values of a multi-valued option). The texts before an update
+        // cannot be kept, they may be in argv, in a file or in the arena, which are all gone after it.
+        uint64_t fingerprint(size_t position) const;
+
+        // Returns an empty list for a slot of an option taking a single value.
+        const List &list(const Slot &slot) const;
+
+        template <typename T>
+        static Range<T> to_range(const std::vector<T> &values)
+        {
+            return {values.data(), values.size()};
+        }
+
+        const Parser *_parser = nullptr;
+        const std::vector<Slot> *_defaults = nullptr; // owned by the parser
+        std::vector<Slot> _slots;                     // one for every option of the parser
+        std::vector<List> _lists;                      // one for every multi-valued option of the parser
+        std::vector<View> _positional;
+        std::unique_ptr<Arena> _arena; // copies of values and positional arguments
+        std::vector<std::unique_ptr<Mapped_File>> _files; // response and configuration files
+        View _subcommand_name;
+        std::unique_ptr<Parse_Result> _subcommand; // values of the subcommand
+        Diagnostic _diagnostic;
+        std::vector<Change> _changes; // recorded only while applying
+        std::vector<std::vector<char>> _applied; // texts set by Parser::apply, a buffer for every option
+        std::vector<uint64_t> _versions; // one for every option, never reset
+        std::vector<uint64_t> _fingerprints; // of the values when begin_update was called
+        uint64_t _generation = 0;
+        bool _applying = false;
+        bool _updating = false; // between begin_update and end_update
+    };
+} // namespace Options
@@ -1,209 +1,1910 @@
 #include <algorithm>
+#include <cerrno>
+#include <cstdlib>
 #include <cstring>
-#include <iomanip>
-#include <sstream>
+#include <mutex>
+#include <utility>
 #include <vector>
 
+#if defined(_WIN32)
+    #include <io.h> // _write
+#else
+    #include <sys/ioctl.h>
+    #include <unistd.h>
+extern char **environ; // NOLINT - not declared by every system header
+#endif
+
+#include "Arena.hpp"
+#include "Config_File.hpp"
+#include "Logic_Error.hpp"
+#include "Mapped_File.hpp"
+#include "Name_Index.hpp"
 #include "Option.hpp"
 #include "Parser.hpp"
+#include "Prefix_Index.hpp"
+#include "Response_File.hpp"
+#include "Snapshot.hpp"
+
+namespace Options
+{
+    namespace
+    {
+        // value of a flag which was given
+        const char *const TRUE_TEXT = "true";
+
+        // "NAME=value" strings of the environment of the process
+        char **environment()
+        {
+#if defined(_WIN32)
+            return _environ;
+#else
+            return environ;
+#endif
+        }
+
+        // Appends the text padded with spaces to the width - like std::setw, a longer text is not cut.
+        void append_padded(std::string &out, View text, size_t width)
+        {
+            out.append(text.data(), text.size());
+            if (text.size() < width)
+                out.append(width - text.size(), ' ');
+        }
+
+        // Appends the text broken at spaces into lines of at most `width` characters (unless a single word is
+        // longer), every line after the first one indented by `indent` spaces. A zero width does not wrap.
+        void append_wrapped(std::string &out, View text, size_t indent, size_t width)
+        {
+            const char *begin = text.data();
+            const char *const end = text.data() + text.size();
+
+            while (width != 0 && static_cast<size_t>(end - begin) > width)
+            {
+                // the last space which still fits, or the first one after a too long word
+                const char *cut = begin + width;
+                while (cut > begin && *cut != ' ')
+                    --cut;
+                if (cut == begin)
+                    cut = std::find(begin + width, end, ' ');
+                if (cut == end)
+                    break;
+
+                out.append(begin, cut);
+                out += '\n';
+                out.append(indent, ' ');
+
+                begin = cut + 1;
+            }
+
+            out.append(begin, end);
+        }
+
+        // Writes the whole text to the file descriptor, retrying after partial writes and interrupts.
+        bool write_all(int fd, const char *text, size_t size)
+        {
+            while (size > 0)
+            {
+#if defined(_WIN32)
+                const int written = _write(fd, text, static_cast<unsigned int>(size));
+#else
+                const ssize_t written = ::write(fd, text, size);
+#endif
+                if (written < 0 && errno == EINTR)
+                    continue;
+                if (written <= 0)
+                    return false;
+
+                text += written;
+                size -= static_cast<size_t>(written);
+            }
+
+            return true;
+        }
+
+        // Tokens of the command line with response files ("@path") replaced by their contents.
+        class Token_Stream
+        {
+        public:
+            using Files = std::vector<std::unique_ptr<Mapped_File>>;
+
+            // Response files are expanded only when files is not null, they are kept alive by it.
+            Token_Stream(int argc, const char *const *argv, int start_idx, Files *files)
+                : _argc{argc}, _argv{argv}, _position{start_idx}, _files{files}
+            {
+            }
+
+            // Returns the next token or nullptr at the end, or when a response file cannot be read or is malformed.
+            const char *next()
+            {
+                if (_in_file)
+                {
+                    if (const char *token = _file.next())
+                        return token;
+
+                    if (_file.malformed())
+                    {
+                        _failed = true;
+                        return nullptr;
+                    }
+
+                    _in_file = false;
+                }
+
+                if (_position >= _argc)
+                    return nullptr;
+
+                _argv_index = _position++;
+                const char *token = _argv[_argv_index];
+
+                if (_files == nullptr || token[0] != '@' || token[1] == '\0')
+                    return token;
+
+                std::unique_ptr<Mapped_File> file(new Mapped_File);
+                if (!file->open(token + 1))
+                {
+                    _failed = true;
+                    return nullptr;
+                }
+
+                _file = Response_File(*file);
+                _in_file = true;
+                _files->push_back(std::move(file));
+
+                return next();
+            }
+
+            bool failed() const { return _failed; }
+            bool malformed() const { return _failed && _file.malformed(); }
+
+            // Takes the following "@path" arguments as they are, like everything after "--".
+            void stop_expanding() { _files = nullptr; }
+
+            // Index in argv of the last token, or of the "@path" argument if the token is in a response file.
+            int argv_index() const { return _argv_index; }
+
+            // The argument of the last token as given, like "@path" for a response file.
+            const char *argument() const { return _argv[_argv_index]; }
+
+            // True if the last token is in a response file, so it does not have to be copied.
+            bool in_file() const { return _in_file; }
+
+            // Number of not yet visited argv strings, every one being at least one token.
+            size_t remaining() const { return static_cast<size_t>(std::max(_argc - _position, 0)); }
+
+        private:
+            int _argc;
+            const char *const *_argv;
+            int _position;
+            int _argv_index = -1;
+            Files *_files;
+            Response_File _file; // tokens of the currently read file
+            bool _in_file = false;
+            bool _failed = false;
+        };
+    } // namespace
+
+    struct Parser::Impl
+    {
+        struct Subcommand
+        {
+            View name;
+            View description;
+            subcommand_factory_t factory;
+            std::once_flag built;
+            std::unique_ptr<Parser> parser; // built on demand
+        };
+
+        // Exact names always win over prefixes - "--bar" means "bar" even if there is "barrel" as well.
+        // Returns the position, Name_Index::NOT_FOUND or Prefix_Index::AMBIGUOUS.
+        uint32_t find_long(const char *name, size_t size) const
+        {
+            const uint32_t position = _index.find_long(name, size);
+
+            if (position != Name_Index::NOT_FOUND || !_prefix_matching)
+                return position;
+
+            return _prefixes.find(name, size);
+        }
+
+        // Builds the prefix index when prefix matching is enabled, unless it is up to date.
+        void build_prefixes()
+        {
+            if (!_prefix_matching || _prefixes_built_for == _options.size())
+                return;
+
+            _prefixes.clear();
+            fill_prefixes(_prefixes);
+            _prefixes_built_for = _options.size();
+        }
+
+        void fill_prefixes(Prefix_Index &prefixes) const
+        {
+            for (size_t i = 0; i < _options.size(); ++i)
+            {
+                const View name = _options[i].long_name();
+
+                // names defined twice are found only by their first definition
+                if (_index.find_long(name.data(), name.size()) == i)
+                    prefixes.add(name, static_cast<uint32_t>(i));
+            }
+
+            prefixes.build();
+        }
+
+        // Appends the completions of the last word - the previous ones select a subcommand or an option
+        // taking a value. Every completion is a line "text<TAB>description".
+        void complete(const char *const *words, size_t count, std::string &out) const
+        {
+            const char *const current = (count > 0) ? words[count - 1] : "";
+
+            for (size_t i = 0; i + 1 < count; ++i)
+            {
+                if (strcmp(words[i], "--") == 0)
+                    return; // only positional arguments follow
+
+                if (words[i][0] == '-')
+                {
+                    const uint32_t position = find_option(words[i]);
+                    if (position != Name_Index::NOT_FOUND && _options[position].has_argument())
+                        ++i; // skip its value
+
+                    continue;
+                }
+
+                const uint32_t subcommand = _subcommand_index.find_long(words[i], strlen(words[i]));
+
+                if (subcommand != Name_Index::NOT_FOUND)
+                {
+                    const Parser &parser = build(*_subcommands[subcommand]);
+                    return parser._impl->complete(words + i + 1, count - i - 1, out);
+                }
+            }
+
+            // a value of the previous option
+            if (count > 1)
+            {
+                const uint32_t position = find_option(words[count - 2]);
+
+                if (position != Name_Index::NOT_FOUND && _options[position].has_argument())
+                    return complete_choices(position, "", current, out);
+            }
+
+            if (current[0] != '-')
+            {
+                const size_t size = strlen(current);
+
+                for (const auto &subcommand: _subcommands)
+                    if (subcommand->name.size() >= size && memcmp(subcommand->name.data(), current, size) == 0)
+                        append_completion(out, "", subcommand->name, subcommand->description);
+
+                return;
+            }
+
+            if (current[1] != '-' && current[1] != '\0')
+                return; // short names are not completed
+
+            const char *const name = (current[1] == '-') ? current + 2 : current + 1;
+            const char *const separator = strchr(name, '=');
+
+            if (separator != nullptr)
+            {
+                const uint32_t position = find_option(std::string(current, separator).c_str());
+
+                if (position != Name_Index::NOT_FOUND)
+                    complete_choices(position, std::string(current, separator + 1), separator + 1, out);
+
+                return;
+            }
+
+            // the names are listed in sorted order, using the prefix index if it is there
+            Prefix_Index local;
+            const bool is_built = _prefix_matching && _prefixes_built_for == _options.size();
+            if (!is_built)
+                fill_prefixes(local);
+
+            const Prefix_Index &prefixes = is_built ? _prefixes : local;
+            prefixes.for_each(name, strlen(name), [this, &out](View long_name, uint32_t position) {
+                append_completion(out, "--", long_name, _options[position].description());
+            });
+        }
+
+        // Returns the position of the option given by the whole token ("--name" or "-x"), or NOT_FOUND.
+        uint32_t find_option(const char *token) const
+        {
+            if (token[0] != '-' || token[1] == '\0')
+                return Name_Index::NOT_FOUND;
+
+            if (token[1] == '-')
+                return _index.find_long(token + 2, strlen(token + 2));
+
+            return (token[2] == '\0') ? _index.find_short(token[1]) : Name_Index::NOT_FOUND;
+        }
+
+        void complete_choices(uint32_t position, const std::string &prefix, const char *current, std::string &out) const
+        {
+            const size_t size = strlen(current);
+
+            for (const View choice: _options[position].choices())
+                if (choice.size() >= size && memcmp(choice.data(), current, size) == 0)
+                    append_completion(out, prefix, choice, {});
+        }
+
+        static void append_completion(std::string &out, const std::string &prefix, View text, View description)
+        {
+            out += prefix;
+            out.append(text.data(), text.size());
+
+            if (!description.empty())
+            {
+                out += '\t';
+                // only the first line, the shells show one line per completion
+                out.append(description.data(), std::find(description.begin(), description.end(), '\n'));
+            }
+
+            out += '\n';
+        }
+
+        Handle add(const Parser &parser, Option &&opt)
+        {
+            if (_frozen)
+                throw_logic_error("option '" + opt.long_name().str() + "' added to a frozen parser");
+
+            const auto position = static_cast<uint32_t>(_options.size());
+
+            _index.add_long(opt.long_name().data(), opt.long_name().size(), position);
+            if (opt.short_name() != Option::SHORT_NOT_USED)
+                _index.add_short(opt.short_name(), position);
+
+            _longest_option_name = std::max<uint32_t>(opt.long_name().size(), _longest_option_name);
+
+            add_layout(opt);
+            _env_names.emplace_back();
+            _options.emplace_back(std::move(opt));
+            bind(parser, _result);
+            invalidate_help();
+
+            return Handle(position);
+        }
+
+        // Describes what a result holds for the option - its default and a list if it is multi-valued.
+        void add_layout(const Option &opt)
+        {
+            const uint32_t list = opt.is_multiple() ? _list_count++ : Parse_Result::NO_LIST;
+            const int32_t choice = opt.find_choice(opt.default_value());
+
+            _defaults.push_back({Value(opt.default_value()), Source::Default, list, choice});
+        }
+
+        // Makes the result hold a slot for every option, new slots get the defaults.
+        void bind(const Parser &parser, Parse_Result &result) const
+        {
+            if (!result._arena) // moved from
+                result._arena.reset(new Arena);
+
+            if (result._parser != &parser) // filled by another parser before
+            {
+                for (size_t i = 0; i < result._versions.size(); ++i)
+                    result.changed(i);
+
+                result._parser = &parser;
+                result._defaults = &_defaults;
+                result._slots.clear();
+                result.reset();
+            }
+
+            for (size_t i = result._slots.size(); i < _defaults.size(); ++i)
+                result._slots.push_back(_defaults[i]);
+
+            result._lists.resize(_list_count);
+            result._versions.resize(_defaults.size());
+        }
+
+        bool parse(int argc, const char *const *argv, int start_idx, Parse_Result &result) const
+        {
+            Token_Stream tokens(argc, argv, start_idx, _response_files ? &result._files : nullptr);
+
+            return parse(tokens, result);
+        }
+
+        bool parse(Token_Stream &tokens, Parse_Result &result) const
+        {
+            // the own result of a parser keeps its values between parses, but not the failure or the subcommand
+            // of the last one
+            result._diagnostic = Diagnostic();
+            result._subcommand_name = View();
+
+            while (const char *token = tokens.next())
+            {
+                if (strcmp(token, "--") == 0)
+                {
+                    tokens.stop_expanding();
+                    add_positionals(tokens, result);
+                    break;
+                }
+
+                if (token[0] != '-' && !_subcommand_index.empty())
+                {
+                    const uint32_t subcommand = _subcommand_index.find_long(token, strlen(token));
+
+                    if (subcommand == Name_Index::NOT_FOUND)
+                        return fail(Error::Unknown_Subcommand, tokens.argv_index(), NO_OPTION, token, {}, result);
+
+                    // the rest of the command line belongs to the subcommand
+                    if (!parse_subcommand(*_subcommands[subcommand], tokens, result))
+                        return false;
+
+                    break;
+                }
+
+                if (!parse_option(token, tokens, result))
+                    return false;
+            }
+
+            if (tokens.failed())
+                return fail_read(tokens, result);
+
+            if (!_env_index.empty() && !parse_env(result))
+                return false;
+
+            if (_config_option.is_valid())
+            {
+                const View path = result._slots[_config_option.index()].value.as_string();
+                if (!path.empty() && !parse_config(path.c_str(), result))
+                    return false;
+            }
+
+            // parsing succeeds if all the mandatory options were found and set
+            for (uint32_t i = 0; i < _options.size(); ++i)
+                if (_options[i].is_mandatory() && result._slots[i].source == Source::Default)
+                    return fail(Error::Missing_Mandatory, -1, i, _options[i].long_name(), {}, result);
+
+            return true;
+        }
+
+        // Parses a token with an option (or options) - one of "--name", "--name=value", "-x", "-xyz", "-xvalue".
+        // The token is scanned in place: a value given in it is a view of its tail, which is NUL-terminated.
+        bool parse_option(const char *token, Token_Stream &tokens, Parse_Result &result) const
+        {
+            if (token[0] != '-' || token[1] == '\0')
+                return fail(Error::Unexpected_Argument, tokens.argv_index(), NO_OPTION, token, {}, result);
+
+            if (token[1] == '-')
+            {
+                const char *name = token + 2;
+                const char *separator = strchr(name, '=');
+                const size_t size = (separator != nullptr) ? static_cast<size_t>(separator - name) : strlen(name);
+
+                const uint32_t position = find_long(name, size);
+
+                if (position == Name_Index::NOT_FOUND || position == Prefix_Index::AMBIGUOUS)
+                {
+                    const Error error = (position == Name_Index::NOT_FOUND) ? Error::Unknown_Option
+                                                                            : Error::Ambiguous_Option;
+                    return fail(error, tokens.argv_index(), NO_OPTION, token, {}, result);
+                }
+
+                if (separator == nullptr)
+                    return take_value(position, token, tokens, result);
+
+                // a flag takes no value
+                if (!_options[position].has_argument())
+                    return fail(Error::Unexpected_Value, tokens.argv_index(), position, token, separator + 1, result);
+
+                return set_value(position, token, separator + 1, tokens, result);
+            }
+
+            // bundled short names, the first one taking a value ends the bundle
+            for (const char *name = token + 1; *name != '\0'; ++name)
+            {
+                const uint32_t position = _index.find_short(*name);
+
+                if (position == Name_Index::NOT_FOUND)
+                    return fail(Error::Unknown_Option, tokens.argv_index(), NO_OPTION, token, {}, result);
+
+                if (_options[position].has_argument())
+                    return (name[1] != '\0') ? set_value(position, token, name + 1, tokens, result)
+                                              : take_value(position, token, tokens, result);
+
+                set_flag(position, result);
+            }
+
+            return true;
+        }
+
+        // Sets a flag or the option to the value in the next token.
+        bool take_value(uint32_t position, const char *token, Token_Stream &tokens, Parse_Result &result) const
+        {
+            if (!_options[position].has_argument())
+            {
+                set_flag(position, result);
+                return true;
+            }
+
+            const int argv_index = tokens.argv_index();
+
+            const char *text = tokens.next();
+            if (text == nullptr) // value not found
+                return tokens.failed() ? fail_read(tokens, result)
+                                       : fail(Error::Missing_Value, argv_index, position, token, {}, result);
+
+            return set_value(position, token, text, tokens, result);
+        }
+
+        bool set_value(uint32_t position, const char *token, const char *text, const Token_Stream &tokens,
+                       Parse_Result &result) const
+        {
+            if (!assign(position, store(text, tokens, result), Source::Command_Line, result))
+                return fail(Error::Invalid_Value, tokens.argv_index(), position, token, text, result);
+
+            return true;
+        }
+
+        bool parse_subcommand(Subcommand &subcommand, Token_Stream &tokens, Parse_Result &result) const
+        {
+            const Parser &parser = build(subcommand);
+            result._subcommand_name = subcommand.name;
+
+            Parse_Result &values = subcommand_values(parser, result);
+
+            if (parser._impl->parse(tokens, values))
+                return true;
+
+            // the texts are owned by the result of the subcommand, which lives as long as this one
+            result._diagnostic = values._diagnostic;
+            return false;
+        }
+
+        // The parser keeps the values of the subcommand in its own result, a separate result in a separate one.
+        Parse_Result &subcommand_values(const Parser &parser, Parse_Result &result) const
+        {
+            if (&result == &_result)
+                return parser._impl->_result;
+
+            if (!result._subcommand)
+                result._subcommand.reset(new Parse_Result);
+
+            parser._impl->bind(parser, *result._subcommand);
+            return *result._subcommand;
+        }
+
+        // Returns the parser of the subcommand, calling its factory the first time. Safe to call from many threads.
+        Parser &build(Subcommand &subcommand) const
+        {
+            std::call_once(subcommand.built, [&subcommand]() {
+                std::unique_ptr<Parser> parser(new Parser);
+                if (subcommand.factory != nullptr)
+                    subcommand.factory(*parser);
+                parser->freeze();
+                subcommand.parser = std::move(parser);
+            });
+
+            return *subcommand.parser;
+        }
+
+        bool parse_config(const char *path, Parse_Result &result) const
+        {
+            std::unique_ptr<Mapped_File> file(new Mapped_File);
+            if (!file->open(path))
+                return fail(Error::Unreadable_File, -1, NO_OPTION, path, {}, result);
+
+            Config_File config(*file);
+            result._files.push_back(std::move(file));
+
+            View key;
+            View text;
+
+            while (config.next(key, text))
+            {
+                const uint32_t position = _index.find_long(key.data(), key.size());
+
+                if (position == Name_Index::NOT_FOUND)
+                    return fail(Error::Unknown_Option, -1, NO_OPTION, key, {}, result, config.line());
+
+                // a flag given only by its name is set
+                const bool is_set_flag = !_options[position].has_argument() && text.empty();
+
+                if (!assign(position, is_set_flag ? View(TRUE_TEXT) : text, Source::Config, result))
+                    return fail(Error::Invalid_Value, -1, position, key, text, result, config.line());
+            }
+
+            if (config.malformed())
+                return fail(Error::Malformed_Config_Line, -1, NO_OPTION, path, {}, result, config.line());
+
+            return true;
+        }
+
+        // Reads the bound variables in a single pass over the environment.
+        bool parse_env(Parse_Result &result) const
+        {
+            for (char **variable = environment(); variable != nullptr && *variable != nullptr; ++variable)
+            {
+                const char *name = *variable;
+                const char *separator = strchr(name, '=');
+
+                if (separator == nullptr)
+                    continue;
+
+                const uint32_t position = _env_index.find_long(name, static_cast<size_t>(separator - name));
+
+                if (position == Name_Index::NOT_FOUND)
+                    continue;
+
+                // the environment can change later, so the value is copied unless in the zero-copy mode
+                const char *text = separator + 1;
+                const bool is_set_flag = !_options[position].has_argument() && text[0] == '\0';
+                const View value = is_set_flag ? View(TRUE_TEXT) : _zero_copy ? View(text) : result._arena->store(text);
+
+                if (!assign(position, value, Source::Environment, result))
+                {
+                    const View variable_name{name, static_cast<size_t>(separator - name)};
+                    return fail(Error::Invalid_Value, -1, position, variable_name, text, result);
+                }
+            }
+
+            return true;
+        }
+
+        // Parses the tokens of Parser::apply. The previous values of the options it sets are recorded, so
+        // a failure restores them, and the options whose values differ afterwards are counted as changed.
+        bool apply(int count, const char *const *argv, Parse_Result &result, std::vector<Handle> *changed) const
+        {
+            if (changed != nullptr)
+                changed->clear();
+
+            result._diagnostic = Diagnostic();
+
+            const Arena::Mark mark = result._arena->mark();
+            Token_Stream tokens(count, argv, 0, nullptr);
+            bool applied = true;
+
+            result._applying = true;
+            while (const char *token = tokens.next())
+                if (!parse_option(token, tokens, result))
+                {
+                    applied = false;
+                    break;
+                }
+            result._applying = false;
+
+            if (!applied)
+            {
+                roll_back(mark, result);
+                return false;
+            }
+
+            for (const auto &change: result._changes)
+                if (has_changed(change, result))
+                {
+                    result.changed(change.position);
+                    if (changed != nullptr)
+                        changed->push_back(Handle(change.position));
+                }
+
+            keep_applied(mark, result);
+            result._changes.clear();
+            return true;
+        }
+
+        // Moves the texts set by a successful apply from the arena into a buffer of every option, so applying
+        // an option again reuses the memory of the value it replaces instead of growing the arena.
+        static void keep_applied(const Arena::Mark &mark, Parse_Result &result)
+        {
+            if (result._applied.size() < result._slots.size())
+                result._applied.resize(result._slots.size());
+
+            for (const auto &change: result._changes)
+            {
+                Parse_Result::Slot &slot = result._slots[change.position];
+                Parse_Result::List *list = (slot.list != Parse_Result::NO_LIST) ? &result._lists[slot.list] : nullptr;
+
+                // every text is followed by its NUL character
+                size_t size = slot.value.as_string().size() + 1;
+                if (list != nullptr)
+                    for (const View piece: list->strings)
+                        size += piece.size() + 1;
+
+                std::vector<char> &buffer = result._applied[change.position];
+                buffer.resize(size);
+
+                char *next = buffer.data();
+                slot.value._text = move_text(slot.value._text, next);
+                if (list != nullptr)
+                    for (View &piece: list->strings)
+                        piece = move_text(piece, next);
+            }
+
+            result._arena->rewind(mark);
+        }
+
+        // Copies the text with its NUL character to the position, which is advanced past it.
+        static View move_text(View text, char *&position)
+        {
+            const View moved(position, text.size());
+
+            memcpy(position, text.data(), text.size());
+            position[text.size()] = '\0';
+            position += text.size() + 1;
+
+            return moved;
+        }
+
+        // Keeps the value of the option before apply changes it for the first time.
+        static void record(uint32_t position, Parse_Result &result)
+        {
+            if (!result._applying)
+                return;
+
+            for (const auto &change: result._changes)
+                if (change.position == position)
+                    return;
+
+            result._changes.push_back({position, result._slots[position], {}});
+
+            // the new values start from an empty list, the old ones are kept aside
+            const uint32_t list = result._slots[position].list;
+            if (list != Parse_Result::NO_LIST)
+                std::swap(result._lists[list], result._changes.back().list);
+        }
+
+        static bool has_changed(const Parse_Result::Change &change, const Parse_Result &result)
+        {
+            const Parse_Result::Slot &slot = result._slots[change.position];
+
+            if (slot.list != Parse_Result::NO_LIST)
+                return result._lists[slot.list].strings != change.list.strings;
+
+            return slot.value.as_string() != change.slot.value.as_string();
+        }
+
+        // Restores the values from before a failed apply and frees the texts it stored, except the diagnostic.
+        static void roll_back(const Arena::Mark &mark, Parse_Result &result)
+        {
+            for (auto &change: result._changes)
+            {
+                result._slots[change.position] = change.slot;
+                if (change.slot.list != Parse_Result::NO_LIST)
+                    std::swap(result._lists[change.slot.list], change.list);
+            }
+            result._changes.clear();
+
+            Diagnostic &diagnostic = result._diagnostic;
+            const std::string token = diagnostic.token.str();
+            const std::string value = diagnostic.value.str();
+
+            result._arena->rewind(mark);
+            diagnostic.token = token.empty() ? View() : result._arena->store(token);
+            diagnostic.value = value.empty() ? View() : result._arena->store(value);
+        }
+
+        // Hash of everything a snapshot depends on: the options with their defaults and choices, and the subcommands.
+        uint64_t fingerprint() const
+        {
+            if (_frozen)
+                return _fingerprint;
+
+            Fingerprint fingerprint;
+
+            for (const auto &opt: _options)
+            {
+                const uint64_t kind = opt.is_flag() ? 0 : opt.is_mandatory() ? 1 : 2;
+                const uint64_t separator = opt.is_multiple() ? static_cast<unsigned char>(opt.separator()) + 1U : 0;
+
+                fingerprint.add(opt.long_name());
+                fingerprint.add(static_cast<unsigned char>(opt.short_name()));
+                fingerprint.add(kind | (separator << 8));
+                fingerprint.add(opt.default_value());
+
+                fingerprint.add(opt.choices().size());
+                for (const View choice: opt.choices())
+                    fingerprint.add(choice);
+            }
+
+            for (const auto &subcommand: _subcommands)
+                fingerprint.add(subcommand->name);
+
+            return fingerprint.value();
+        }
+
+        // Writes the header, the set values with their lists, the positional arguments and the subcommand
+        // (as a nested snapshot of its parser).
+        void save(const Parse_Result &result, Snapshot_Writer &out) const
+        {
+            out.u32(SNAPSHOT_MAGIC);
+            out.u32(SNAPSHOT_VERSION);
+            out.u64(fingerprint());
+            out.u32(static_cast<uint32_t>(_options.size()));
+
+            for (const auto &slot: result._slots)
+            {
+                out.u8(static_cast<uint8_t>(slot.source));
+                if (slot.source == Source::Default)
+                    continue;
+
+                save(slot.value, out);
+                out.u32(static_cast<uint32_t>(slot.choice));
+
+                if (slot.list == Parse_Result::NO_LIST)
+                    continue;
+
+                const Parse_Result::List &list = result._lists[slot.list];
+                out.u32(static_cast<uint32_t>(list.strings.size()));
+                for (size_t i = 0; i < list.strings.size(); ++i)
+                {
+                    out.text(list.strings[i]);
+                    out.u64(static_cast<uint64_t>(list.int64s[i]));
+                    out.f64(list.doubles[i]);
+                }
+            }
+
+            out.u32(static_cast<uint32_t>(result._positional.size()));
+            for (const View positional: result._positional)
+                out.text(positional);
+
+            out.text(result._subcommand_name);
+            if (result._subcommand_name.empty())
+                return;
+
+            const uint32_t position = _subcommand_index.find_long(result._subcommand_name.data(),
+                                                                  result._subcommand_name.size());
+            const Parser &parser = build(*_subcommands[position]);
+            const Parse_Result &values = (&result == &_result) ? parser._impl->_result : *result._subcommand;
+            parser._impl->save(values, out);
+        }
+
+        static void save(const Value &value, Snapshot_Writer &out)
+        {
+            out.text(value._text);
+            out.u32(static_cast<uint32_t>(value._integer));
+            out.u64(static_cast<uint64_t>(value._int64));
+            out.u64(value._uint64);
+            out.f64(value._real);
+            out.u8(static_cast<uint8_t>(value._boolean | (value._is_int64 << 1) | (value._is_uint64 << 2) |
+                                        (value._is_double << 3)));
+        }
+
+        // Reads what save wrote into a reset result. Only the texts are copied, nothing is converted or validated.
+        bool load(Snapshot_Reader &in, Parse_Result &result) const
+        {
+            if (in.u32() != SNAPSHOT_MAGIC || in.u32() != SNAPSHOT_VERSION)
+                return fail(Error::Malformed_Snapshot, -1, NO_OPTION, {}, {}, result);
+
+            if (in.u64() != fingerprint() || in.u32() != _options.size())
+                return in.failed() ? fail(Error::Malformed_Snapshot, -1, NO_OPTION, {}, {}, result)
+                                   : fail(Error::Schema_Mismatch, -1, NO_OPTION, {}, {}, result);
+
+            for (uint32_t i = 0; i < _options.size(); ++i)
+                if (!load(i, in, result))
+                    return fail(Error::Malformed_Snapshot, -1, i, {}, {}, result);
+
+            const uint32_t positional_count = in.u32();
+            for (uint32_t i = 0; i < positional_count && !in.failed(); ++i)
+                result._positional.push_back(result._arena->store(in.text()));
+
+            const View name = in.text();
+            if (in.failed())
+                return fail(Error::Malformed_Snapshot, -1, NO_OPTION, {}, {}, result);
+
+            if (name.empty())
+                return true;
+
+            const uint32_t position = _subcommand_index.find_long(name.data(), name.size());
+            if (position == Name_Index::NOT_FOUND)
+                return fail(Error::Malformed_Snapshot, -1, NO_OPTION, {}, {}, result);
+
+            Subcommand &subcommand = *_subcommands[position];
+            const Parser &subcommand_parser = build(subcommand);
+            result._subcommand_name = subcommand.name;
+
+            Parse_Result &values = subcommand_values(subcommand_parser, result);
+            if (subcommand_parser._impl->load(in, values))
+                return true;
+
+            result._diagnostic = values._diagnostic;
+            return false;
+        }
+
+        bool load(uint32_t position, Snapshot_Reader &in, Parse_Result &result) const
+        {
+            const uint8_t source = in.u8();
+            if (source > static_cast<uint8_t>(Source::Command_Line))
+                return false;
+
+            if (source == static_cast<uint8_t>(Source::Default))
+                return !in.failed();
+
+            Parse_Result::Slot &slot = result._slots[position];
+            slot.source = static_cast<Source>(source);
+            load(in, slot.value, result);
+            count_change(position, result);
+
+            slot.choice = static_cast<int32_t>(in.u32());
+            if (slot.choice < Option::NO_CHOICE ||
+                slot.choice >= static_cast<int32_t>(_options[position].choices().size()))
+                return false;
+
+            if (slot.list == Parse_Result::NO_LIST)
+                return !in.failed();
+
+            Parse_Result::List &list = result._lists[slot.list];
+            const uint32_t count = in.u32();
+
+            for (uint32_t i = 0; i < count && !in.failed(); ++i)
+            {
+                list.strings.push_back(result._arena->store(in.text()));
+                list.int64s.push_back(static_cast<int64_t>(in.u64()));
+                list.doubles.push_back(in.f64());
+            }
+
+            return !in.failed();
+        }
+
+        static void load(Snapshot_Reader &in, Value &value, Parse_Result &result)
+        {
+            value._text = result._arena->store(in.text());
+            value._integer = static_cast<int32_t>(in.u32());
+            value._int64 = static_cast<int64_t>(in.u64());
+            value._uint64 = in.u64();
+            value._real = in.f64();
+
+            const uint8_t flags = in.u8();
+            value._boolean = (flags & 1) != 0;
+            value._is_int64 = (flags & 2) != 0;
+            value._is_uint64 = (flags & 4) != 0;
+            value._is_double = (flags & 8) != 0;
+        }
+
+        bool load_snapshot(const void *data, size_t size, Parse_Result &result) const
+        {
+            Snapshot_Reader in(data, size);
+
+            if (!load(in, result))
+                return false;
+
+            return in.at_end() || fail(Error::Malformed_Snapshot, -1, NO_OPTION, {}, {}, result);
+        }
+
+        // Records why parsing failed and returns false. Only the first failure is recorded. The texts are
+        // copied, as the argv strings or the environment do not have to outlive the result.
+        bool fail(Error error, int argv_index, uint32_t position, View token, View value, Parse_Result &result,
+                  size_t line = 0) const
+        {
+            Diagnostic &diagnostic = result._diagnostic;
+
+            if (diagnostic.error != Error::None)
+                return false;
+
+            diagnostic.error = error;
+            diagnostic.argv_index = argv_index;
+            diagnostic.line = line;
+            diagnostic.option = Handle(position);
+            diagnostic.token = token.empty() ? View() : result._arena->store(token);
+            diagnostic.value = value.empty() ? View() : result._arena->store(value);
+
+            return false;
+        }
+
+        // A response file given by the current argument cannot be read or has an unterminated quote.
+        bool fail_read(const Token_Stream &tokens, Parse_Result &result) const
+        {
+            const Error error = tokens.malformed() ? Error::Malformed_Response_File : Error::Unreadable_File;
+            return fail(error, tokens.argv_index(), NO_OPTION, tokens.argument() + 1, {}, result);
+        }
+
+        void set_flag(uint32_t position, Parse_Result &result) const
+        {
+            record(position, result);
+
+            auto &slot = result._slots[position];
+            if (slot.value.as_string() != _true.as_string())
+                count_change(position, result);
+
+            slot.value = _true;
+            slot.source = Source::Command_Line;
+        }
+
+        // Validates and sets the value, unless it was already set by a source with a higher precedence.
+        bool assign(uint32_t position, View text, Source source, Parse_Result &result) const
+        {
+            auto &slot = result._slots[position];
+
+            if (slot.source > source)
+                return true;
+
+            record(position, result);
+
+            if (slot.list != Parse_Result::NO_LIST)
+            {
+                if (!append(position, text, source, result))
+                    return false;
+
+                count_change(position, result);
+                return true;
+            }
+
+            const Option &opt = _options[position];
+            const Value value{text};
+
+            // the choice is resolved once here, so reading it later is a load
+            const int32_t choice = opt.find_choice(text);
+            if (opt.is_choice() && choice == Option::NO_CHOICE)
+                return false;
+
+            // validate the value if there is a validator
+            if (!opt.accepts(value))
+                return false;
+
+            if (slot.value.as_string() != text)
+                count_change(position, result);
+
+            slot.value = value;
+            slot.source = source;
+            slot.choice = choice;
+            return true;
+        }
+
+        // Changes made by apply are counted once it succeeds, and the ones made by parsing into a separate result
+        // once it ends (see Parse_Result::begin_update), only for the options which differ then.
+        static void count_change(uint32_t position, Parse_Result &result)
+        {
+            if (!result._applying && !result._updating)
+                result.changed(position);
+        }
+
+        // Appends the values of a multi-valued option, a source with a higher precedence replaces them.
+        // Either all the values of the text are accepted or the list stays as it was.
+        bool append(uint32_t position, View text, Source source, Parse_Result &result) const
+        {
+            const Option &opt = _options[position];
+            auto &slot = result._slots[position];
+            auto &list = result._lists[slot.list];
+            const size_t previous_size = list.strings.size();
+
+            const char *begin = text.data();
+            const char *const end = text.data() + text.size();
+            Value value;
+
+            while (true)
+            {
+                const char *separator = nullptr;
+                if (opt.separator() != Option::SEPARATOR_NOT_USED)
+                    separator = static_cast<const char *>(memchr(begin, opt.separator(), end - begin));
+
+                const char *const piece_end = (separator != nullptr) ? separator : end;
+
+                // the whole text is already NUL-terminated, values from a list need copies to be
+                const View piece = (begin == text.data() && piece_end == end)
+                                       ? text
+                                       : result._arena->store({begin, static_cast<size_t>(piece_end - begin)});
+                value = Value(piece);
+
+                if (!opt.accepts(value))
+                {
+                    list.strings.resize(previous_size);
+                    list.int64s.resize(previous_size);
+                    list.doubles.resize(previous_size);
+                    return false;
+                }
+
+                list.strings.push_back(piece);
+                list.int64s.push_back(value.as_int64());
+                list.doubles.push_back(value.as_double());
+
+                if (separator == nullptr)
+                    break;
+
+                begin = separator + 1;
+            }
+
+            // the values of a source with a lower precedence are replaced
+            if (slot.source < source)
+            {
+                list.strings.erase(list.strings.begin(), list.strings.begin() + previous_size);
+                list.int64s.erase(list.int64s.begin(), list.int64s.begin() + previous_size);
+                list.doubles.erase(list.doubles.begin(), list.doubles.begin() + previous_size);
+            }
+
+            slot.value = value;
+            slot.source = source;
+            return true;
+        }
+
+        void add_positionals(Token_Stream &tokens, Parse_Result &result) const
+        {
+            auto &positional = result._positional;
+            positional.reserve(positional.size() + tokens.remaining());
+
+            while (const char *token = tokens.next())
+                positional.push_back(store(token, tokens, result));
+        }
+
+        // Texts of argv are copied unless in the zero-copy mode, the ones in response files never are.
+        View store(const char *text, const Token_Stream &tokens, Parse_Result &result) const
+        {
+            if ((_zero_copy && !result._applying) || tokens.in_file())
+                return text;
+
+            return result._arena->store(text);
+        }
+
+        // Calls the function with the help text for the width. It is rendered only when the options changed or
+        // the width is different than the last time, and the function is called under the lock of the cache.
+        template <typename Function>
+        auto with_help(size_t width, Function function) const -> decltype(function(std::string()))
+        {
+            std::lock_guard<std::mutex> lock(_help_mutex);
+
+            if (!_help_valid || _help_width != width)
+            {
+                render_help(width, _help);
+                _help_width = width;
+                _help_valid = true;
+            }
+
+            return function(static_cast<const std::string &>(_help));
+        }
+
+        void invalidate_help()
+        {
+            std::lock_guard<std::mutex> lock(_help_mutex);
+            _help_valid = false;
+        }
+
+        // Renders the options (and subcommands) - names in the first column, descriptions in the second.
+        void render_help(size_t width, std::string &out) const
+        {
+            constexpr size_t MIN_TEXT_WIDTH = 8;
+            constexpr size_t MIN_DESCRIPTION_WIDTH = 20; // narrower terminals are not wrapped for
+
+            const size_t names_width = MIN_TEXT_WIDTH + _longest_option_name;
+            const size_t indent = 1 + names_width + 2;
+            const size_t wrap = (width >= indent + MIN_DESCRIPTION_WIDTH) ? width - indent : 0;
+
+            out.clear();
+
+            std::string names; // reused for every option
+            std::string text;
+
+            for (size_t i = 0; i < _options.size(); ++i)
+            {
+                const Option &opt = _options[i];
+
+                names.clear();
+                if (opt.short_name() != Option::SHORT_NOT_USED)
+                {
+                    names += '-';
+                    names += opt.short_name();
+                    names += ", ";
+                }
+                else
+                    names += "    ";
+
+                names += "--";
+                names.append(opt.long_name().data(), opt.long_name().size());
+
+                out += ' ';
+                append_padded(out, names, names_width);
+                out += opt.is_mandatory() ? "M " : "  ";
+
+                text.assign(opt.description().data(), opt.description().size());
+
+                if (opt.is_choice())
+                {
+                    text += " (one of:";
+                    for (const View choice: opt.choices())
+                    {
+                        text += ' ';
+                        text.append(choice.data(), choice.size());
+                    }
+                    text += ')';
+                }
+
+                if (opt.is_multiple())
+                    text += " (can be repeated)";
+                else if (opt.is_optional())
+                {
+                    text += " (default: ";
+                    text.append(opt.default_value().data(), opt.default_value().size());
+                    text += ')';
+                }
+
+                if (!_env_names[i].empty())
+                {
+                    text += " (env: ";
+                    text.append(_env_names[i].data(), _env_names[i].size());
+                    text += ')';
+                }
+
+                append_wrapped(out, text, indent, wrap);
+                out += '\n';
+            }
+
+            if (!_subcommands.empty())
+            {
+                out += "Subcommands:\n";
+
+                for (const auto &subcommand: _subcommands)
+                {
+                    out += ' ';
+                    append_padded(out, subcommand->name, names_width + 2);
+                    append_wrapped(out, subcommand->description, indent, wrap);
+                    out += '\n';
+                }
+            }
+        }
+
+        static constexpr uint32_t NO_OPTION = Handle::INVALID;
+        static constexpr uint32_t SNAPSHOT_MAGIC = 0x5354504F; // "OPTS"
+        static constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+        // all the texts of the options - names, descriptions and defaults
+        std::shared_ptr<Arena> _arena = std::make_shared<Arena>();
+        std::vector<Option> _options;
+        std::vector<Parse_Result::Slot> _defaults; // what a result holds for every option when not set
+        uint32_t _list_count = 0;                  // number of multi-valued options
+        Name_Index _index;
+        bool _prefix_matching = false;
+        Prefix_Index _prefixes;         // sorted long names, when prefix matching is enabled
+        size_t _prefixes_built_for = 0; // number of options when the prefix index was built
+        Name_Index _env_index;          // names of environment variables bound to options
+        std::vector<View> _env_names;   // name of the variable bound to every option or empty
+        uint32_t _longest_option_name = 0;
+        bool _zero_copy = false;
+        bool _response_files = false;
+        Handle _config_option; // option with the path of a configuration file
+        std::vector<std::unique_ptr<Subcommand>> _subcommands;
+        Name_Index _subcommand_index;
+        bool _frozen = false;
+        uint64_t _fingerprint = 0; // of the options, computed by freeze
+        const Value _true{View(TRUE_TEXT)};
+
+        Parse_Result _result; // used by the non-const methods of the parser
+
+        // the last rendered help text, so showing it again costs just a copy or a write
+        mutable std::mutex _help_mutex;
+        mutable std::string _help;
+        mutable size_t _help_width = 0;
+        mutable bool _help_valid = false;
+    };
+
+    Parser::Parser() : _impl(new Impl)
+    {
+        _impl->bind(*this, _impl->_result);
+    }
+
+    Parser::~Parser() {}
+
+    Handle Parser::add_flag(const std::string &long_name, char short_name, const std::string &description)
+    {
+        return _impl->add(*this, {_impl->_arena, long_name, short_name, description});
+    }
+
+    Handle Parser::add_flag(const std::string &long_name, const std::string &description)
+    {
+        return add_flag(long_name, Option::SHORT_NOT_USED, description);
+    }
+
+    Handle Parser::add_optional(const std::string &long_name, char short_name, const std::string &description,
+                                const std::string &default_value, validator_t validator)
+    {
+        Option opt{_impl->_arena, long_name, short_name, description};
+        opt.set_optional(default_value).set_validator(validator);
+
+        return _impl->add(*this, std::move(opt));
+    }
+
+    Handle Parser::add_optional(const std::string &long_name, const std::string &description,
+                                const std::string &default_value, validator_t validator)
+    {
+        return add_optional(long_name, Option::SHORT_NOT_USED, description, default_value, validator);
+    }
+
+    Handle Parser::add_mandatory(const std::string &long_name, char short_name, const std::string &description,
+                                 validator_t validator)
+    {
+        Option opt{_impl->_arena, long_name, short_name, description};
+        opt.set_mandatory().set_validator(validator);
+
+        return _impl->add(*this, std::move(opt));
+    }
 
-namespace Options
-{
-    struct Parser::Impl
+    Handle Parser::add_mandatory(const std::string &long_name, const std::string &description, validator_t validator)
     {
-        // This will throw an exception if the option is not found.
-        std::vector<Option>::const_iterator find_option_by_long_name(const std::string &name) const
-        {
-            auto iter = std::find_if(_options.cbegin(), _options.cend(),
-                                     [&name](const Option &opt) { return opt.long_name() == name; });
+        return add_mandatory(long_name, Option::SHORT_NOT_USED, description, validator);
+    }
 
-            if (iter == _options.cend())
-                throw std::logic_error("option '" + name + "' not found");
+    Handle Parser::add_optional(const std::string &long_name, char short_name, const std::string &description,
+                                const std::string &default_value, Validator validator)
+    {
+        Option opt{_impl->_arena, long_name, short_name, description};
+        opt.set_optional(default_value).set_validator(std::move(validator));
 
-            return iter;
-        }
+        return _impl->add(*this, std::move(opt));
+    }
 
-        // Return an iterator to the option if found, or _options.end() otherwise.
-        std::vector<Option>::iterator find_option_by_name_with_dashes(const std::string &name)
-        {
-            return std::find_if(_options.begin(), _options.end(), [&name](const Option &opt) {
-                if (name == (std::string("-") + opt.short_name()))
-                    return true;
+    Handle Parser::add_optional(const std::string &long_name, const std::string &description,
+                                const std::string &default_value, Validator validator)
+    {
+        return add_optional(long_name, Option::SHORT_NOT_USED, description, default_value, validator);
+    }
 
-                if (name == ("--" + opt.long_name()))
-                    return true;
+    Handle Parser::add_mandatory(const std::string &long_name, char short_name, const std::string &description,
+                                 Validator validator)
+    {
+        Option opt{_impl->_arena, long_name, short_name, description};
+        opt.set_mandatory().set_validator(std::move(validator));
 
-                return false;
-            });
-        }
+        return _impl->add(*this, std::move(opt));
+    }
 
-        Option &add(const Option &&opt)
-        {
-            _options.emplace_back(opt);
+    Handle Parser::add_mandatory(const std::string &long_name, const std::string &description,
+                                 Validator validator)
+    {
+        return add_mandatory(long_name, Option::SHORT_NOT_USED, description, validator);
+    }
 
-            _longest_option_name = std::max<uint32_t>(opt.long_name().size(), _longest_option_name);
+    Handle Parser::add_multiple(const std::string &long_name, char short_name, const std::string &description,
+                                char separator, Validator validator)
+    {
+        Option opt{_impl->_arena, long_name, short_name, description};
+        opt.set_multiple(separator).set_validator(std::move(validator));
 
-            return _options.back();
-        }
+        return _impl->add(*this, std::move(opt));
+    }
 
-        std::vector<Option> _options;
-        uint32_t _longest_option_name = 0;
-        std::vector<std::string> _positional;
-    };
+    Handle Parser::add_multiple(const std::string &long_name, const std::string &description, char separator,
+                                Validator validator)
+    {
+        return add_multiple(long_name, Option::SHORT_NOT_USED, description, separator, validator);
+    }
 
-    Parser::Parser() : _impl(new Impl) {}
+    Handle Parser::add_choice(const std::string &long_name, char short_name, const std::string &description,
+                              std::initializer_list<const char *> choices, const std::string &default_value)
+    {
+        Option opt{_impl->_arena, long_name, short_name, description};
+        opt.set_optional(default_value).set_choices(choices);
 
-    Parser::~Parser() {}
+        return _impl->add(*this, std::move(opt));
+    }
 
-    void Parser::add_flag(const std::string &long_name, char short_name, const std::string &description)
+    Handle Parser::add_choice(const std::string &long_name, const std::string &description,
+                              std::initializer_list<const char *> choices, const std::string &default_value)
     {
-        _impl->add({long_name, short_name, description});
+        return add_choice(long_name, Option::SHORT_NOT_USED, description, choices, default_value);
     }
 
-    void Parser::add_flag(const std::string &long_name, const std::string &description)
+    Range<View> Parser::choices(Handle handle) const
     {
-        add_flag(long_name, Option::SHORT_NOT_USED, description);
+        return _impl->_options[handle.index()].choices();
     }
 
-    void Parser::add_optional(const std::string &long_name, char short_name, const std::string &description,
-                              const std::string &default_value, validator_t validator)
+    Handle Parser::find(const std::string &name) const
     {
-        _impl->add({long_name, short_name, description}).set_optional(default_value).set_validator(validator);
+        const uint32_t position = _impl->_index.find_long(name.data(), name.size());
+
+        if (position == Name_Index::NOT_FOUND)
+            return {};
+
+        return Handle(position);
     }
 
-    void Parser::add_optional(const std::string &long_name, const std::string &description,
-                              const std::string &default_value, validator_t validator)
+    void Parser::set_zero_copy(bool enabled)
     {
-        add_optional(long_name, Option::SHORT_NOT_USED, description, default_value, validator);
+        _impl->_zero_copy = enabled;
     }
 
-    void Parser::add_mandatory(const std::string &long_name, char short_name, const std::string &description,
-                               validator_t validator)
+    void Parser::set_response_files(bool enabled)
     {
-        _impl->add({long_name, short_name, description}).set_mandatory().set_validator(validator);
+        _impl->_response_files = enabled;
     }
 
-    void Parser::add_mandatory(const std::string &long_name, const std::string &description, validator_t validator)
+    void Parser::set_prefix_matching(bool enabled)
     {
-        add_mandatory(long_name, Option::SHORT_NOT_USED, description, validator);
+        _impl->_prefix_matching = enabled;
+        _impl->_prefixes_built_for = 0;
+
+        if (_impl->_frozen)
+            _impl->build_prefixes();
     }
 
     bool Parser::parse(int argc, const char *const *argv, int start_idx)
     {
-        int pos = start_idx;
+        _impl->build_prefixes();
+
+        return _impl->parse(argc, argv, start_idx, _impl->_result);
+    }
+
+    bool Parser::parse(int argc, const char *const *argv, Parse_Result &result, int start_idx) const
+    {
+        if (!_impl->_frozen)
+            throw_logic_error("parsing into a separate result requires a frozen parser");
+
+        _impl->bind(*this, result);
+        result.begin_update();
+        result.reset(); // every parse starts from scratch, the result only keeps its memory
+
+        const bool parsed = _impl->parse(argc, argv, start_idx, result);
+        result.end_update();
+        return parsed;
+    }
+
+    bool Parser::apply(int count, const char *const *tokens, std::vector<Handle> *changed)
+    {
+        _impl->build_prefixes();
+
+        return _impl->apply(count, tokens, _impl->_result, changed);
+    }
+
+    bool Parser::apply(int count, const char *const *tokens, Parse_Result &result,
+                       std::vector<Handle> *changed) const
+    {
+        if (!_impl->_frozen)
+            throw_logic_error("applying into a separate result requires a frozen parser");
+
+        _impl->bind(*this, result);
+
+        return _impl->apply(count, tokens, result, changed);
+    }
+
+    void Parser::add_subcommand(const std::string &name, const std::string &description,
+                                subcommand_factory_t factory)
+    {
+        if (_impl->_frozen)
+            throw_logic_error("subcommand '" + name + "' added to a frozen parser");
+
+        const auto position = static_cast<uint32_t>(_impl->_subcommands.size());
+        if (!_impl->_subcommand_index.add_long(name.data(), name.size(), position))
+            return; // the first definition wins
+
+        std::unique_ptr<Impl::Subcommand> subcommand(new Impl::Subcommand);
+        subcommand->name = _impl->_arena->store(name);
+        subcommand->description = _impl->_arena->store(description);
+        subcommand->factory = factory;
+
+        _impl->_subcommands.push_back(std::move(subcommand));
+        _impl->invalidate_help();
+    }
+
+    View Parser::subcommand_name() const
+    {
+        return _impl->_result.subcommand();
+    }
+
+    Parser &Parser::subcommand(const std::string &name)
+    {
+        const uint32_t position = _impl->_subcommand_index.find_long(name.data(), name.size());
+
+        if (position == Name_Index::NOT_FOUND)
+            throw_logic_error("subcommand '" + name + "' not found");
+
+        return _impl->build(*_impl->_subcommands[position]);
+    }
+
+    void Parser::bind_env(Handle handle, const std::string &variable)
+    {
+        if (_impl->_frozen)
+            throw_logic_error("environment variable '" + variable + "' bound in a frozen parser");
+
+        if (_impl->_env_index.add_long(variable.data(), variable.size(), handle.index()))
+            _impl->_env_names[handle.index()] = _impl->_arena->store(variable);
+
+        _impl->invalidate_help();
+    }
+
+    void Parser::set_config_option(Handle handle)
+    {
+        _impl->_config_option = handle;
+    }
+
+    bool Parser::parse_config(const std::string &path)
+    {
+        _impl->_result._diagnostic = Diagnostic();
+
+        return _impl->parse_config(path.c_str(), _impl->_result);
+    }
+
+    bool Parser::parse_config(const std::string &path, Parse_Result &result) const
+    {
+        if (!_impl->_frozen)
+            throw_logic_error("parsing into a separate result requires a frozen parser");
+
+        _impl->bind(*this, result);
+        result._diagnostic = Diagnostic();
+
+        return _impl->parse_config(path.c_str(), result);
+    }
+
+    const Diagnostic &Parser::diagnostic() const
+    {
+        return _impl->_result.diagnostic();
+    }
+
+    void Parser::reset()
+    {
+        _impl->_result.reset();
+
+        for (const auto &subcommand: _impl->_subcommands)
+            if (subcommand->parser)
+                subcommand->parser->reset();
+    }
+
+    void Parser::freeze()
+    {
+        _impl->_fingerprint = _impl->fingerprint();
+        _impl->_frozen = true;
+        _impl->build_prefixes();
+    }
+
+    bool Parser::is_frozen() const
+    {
+        return _impl->_frozen;
+    }
+
+    std::string Parser::save_snapshot() const
+    {
+        return save_snapshot(_impl->_result);
+    }
+
+    std::string Parser::save_snapshot(const Parse_Result &result) const
+    {
+        if (result._parser != this)
+            throw_logic_error("snapshot of a result filled by another parser");
+
+        std::string snapshot;
+        snapshot.reserve(64 + _impl->_options.size()); // a byte for every option not set
+        Snapshot_Writer out(snapshot);
+        _impl->save(result, out);
+
+        return snapshot;
+    }
+
+    bool Parser::load_snapshot(const void *data, size_t size)
+    {
+        reset();
 
-        bool collect_positionals = false;
+        if (_impl->load_snapshot(data, size, _impl->_result))
+            return true;
 
-        while (pos < argc)
+        // nothing of a damaged snapshot is kept, the diagnostic has no texts to lose
+        const Diagnostic diagnostic = _impl->_result._diagnostic;
+        reset();
+        _impl->_result._diagnostic = diagnostic;
+        return false;
+    }
+
+    bool Parser::load_snapshot(const void *data, size_t size, Parse_Result &result) const
+    {
+        if (!_impl->_frozen)
+            throw_logic_error("loading into a separate result requires a frozen parser");
+
+        _impl->bind(*this, result);
+        result.begin_update();
+        result.reset();
+
+        const bool loaded = _impl->load_snapshot(data, size, result);
+        if (!loaded)
         {
-            if (collect_positionals)
-            {
-                _impl->_positional.push_back(argv[pos]);
-            }
-            else
-            {
-                if (strcmp(argv[pos], "--") == 0)
-                {
-                    collect_positionals = true;
-                }
-                else
-                {
-                    auto iter = _impl->find_option_by_name_with_dashes(argv[pos]);
+            const Diagnostic diagnostic = result._diagnostic;
+            result.reset();
+            result._diagnostic = diagnostic;
+        }
 
-                    if (iter == _impl->_options.end()) // not found
-                        return false;
+        result.end_update();
+        return loaded;
+    }
 
-                    if (iter->has_argument())
-                    {
-                        pos += 1;
-                        if (pos >= argc) // value not found
-                            return false;
+    uint64_t Parser::schema_fingerprint() const
+    {
+        return _impl->fingerprint();
+    }
 
-                        // set the value and validate it if there is a validator
-                        if (!iter->set_value(argv[pos]))
-                            return false;
-                    }
-                    else // no arguments, so it is a flag
-                    {
-                        iter->set_value("true");
-                    }
-                }
-            }
+    std::unique_ptr<Parser> Parser::clone_schema() const
+    {
+        std::unique_ptr<Parser> clone(new Parser);
+        Impl &impl = *clone->_impl;
 
-            pos += 1;
+        impl._options.reserve(_impl->_options.size());
+        for (const auto &opt: _impl->_options)
+        {
+            impl._options.emplace_back(impl._arena, opt);
+            impl.add_layout(impl._options.back());
         }
 
-        // this method succeeds if all the mandatory options were found and set
-        const auto NON_MANDATORY_OR_FOUND = [](const Option &opt) { return (!opt.is_mandatory() || opt.was_set()); };
+        impl._index = _impl->_index;
+        impl._env_index = _impl->_env_index;
+        for (const auto &env_name: _impl->_env_names)
+            impl._env_names.push_back(env_name.empty() ? View() : impl._arena->store(env_name));
+        impl._longest_option_name = _impl->_longest_option_name;
+        impl._zero_copy = _impl->_zero_copy;
+        impl._response_files = _impl->_response_files;
+        impl._prefix_matching = _impl->_prefix_matching;
+        impl._config_option = _impl->_config_option;
+        impl._subcommand_index = _impl->_subcommand_index;
+
+        for (const auto &subcommand: _impl->_subcommands)
+        {
+            std::unique_ptr<Impl::Subcommand> copy(new Impl::Subcommand);
+            copy->name = impl._arena->store(subcommand->name);
+            copy->description = impl._arena->store(subcommand->description);
+            copy->factory = subcommand->factory;
+            impl._subcommands.push_back(std::move(copy));
+        }
+        impl._frozen = _impl->_frozen;
+        impl._fingerprint = _impl->_fingerprint;
+        impl.build_prefixes();
+        impl.bind(*clone, impl._result);
 
-        return std::all_of(_impl->_options.cbegin(), _impl->_options.cend(), NON_MANDATORY_OR_FOUND);
+        return clone;
     }
 
     size_t Parser::positional_count() const
     {
-        return _impl->_positional.size();
+        return _impl->_result.positional_count();
+    }
+
+    std::string Parser::positional(size_t idx) const
+    {
+        return _impl->_result.positional(idx);
     }
 
-    const std::string &Parser::positional(size_t idx) const
+    View Parser::positional_view(size_t idx) const
     {
-        return _impl->_positional.at(idx);
+        return _impl->_result.positional_view(idx);
+    }
+
+    Range<View> Parser::positionals() const
+    {
+        return _impl->_result.positionals();
     }
 
     int32_t Parser::as_int(const std::string &name) const
     {
-        return _impl->find_option_by_long_name(name)->as_int();
+        return _impl->_result.as_int(name);
     }
 
     uint32_t Parser::as_uint(const std::string &name) const
     {
-        return _impl->find_option_by_long_name(name)->as_uint();
+        return _impl->_result.as_uint(name);
+    }
+
+    int64_t Parser::as_int64(const std::string &name) const
+    {
+        return _impl->_result.as_int64(name);
+    }
+
+    uint64_t Parser::as_uint64(const std::string &name) const
+    {
+        return _impl->_result.as_uint64(name);
     }
 
     double Parser::as_double(const std::string &name) const
     {
-        return _impl->find_option_by_long_name(name)->as_double();
+        return _impl->_result.as_double(name);
     }
 
     bool Parser::as_bool(const std::string &name) const
     {
-        return _impl->find_option_by_long_name(name)->as_bool();
+        return _impl->_result.as_bool(name);
+    }
+
+    std::string Parser::as_string(const std::string &name) const
+    {
+        return _impl->_result.as_string(name);
+    }
+
+    View Parser::as_view(const std::string &name) const
+    {
+        return _impl->_result.as_view(name);
+    }
+
+    bool Parser::try_get(const std::string &name, int32_t &value) const
+    {
+        return _impl->_result.try_get(name, value);
+    }
+
+    bool Parser::try_get(const std::string &name, uint32_t &value) const
+    {
+        return _impl->_result.try_get(name, value);
+    }
+
+    bool Parser::try_get(const std::string &name, int64_t &value) const
+    {
+        return _impl->_result.try_get(name, value);
+    }
+
+    bool Parser::try_get(const std::string &name, uint64_t &value) const
+    {
+        return _impl->_result.try_get(name, value);
+    }
+
+    bool Parser::try_get(const std::string &name, double &value) const
+    {
+        return _impl->_result.try_get(name, value);
+    }
+
+    bool Parser::try_get(const std::string &name, bool &value) const
+    {
+        return _impl->_result.try_get(name, value);
+    }
+
+    bool Parser::try_get(const std::string &name, View &value) const
+    {
+        return _impl->_result.try_get(name, value);
+    }
+
+    int32_t Parser::as_choice(const std::string &name) const
+    {
+        return _impl->_result.as_choice(name);
+    }
+
+    int32_t Parser::as_choice(Handle handle) const
+    {
+        return _impl->_result.as_choice(handle);
+    }
+
+    Source Parser::source(const std::string &name) const
+    {
+        return _impl->_result.source(name);
+    }
+
+    Source Parser::source(Handle handle) const
+    {
+        return _impl->_result.source(handle);
+    }
+
+    bool Parser::was_set(const std::string &name) const
+    {
+        return _impl->_result.was_set(name);
+    }
+
+    bool Parser::was_set(Handle handle) const
+    {
+        return _impl->_result.was_set(handle);
+    }
+
+    uint64_t Parser::version(const std::string &name) const
+    {
+        return _impl->_result.version(name);
+    }
+
+    uint64_t Parser::version(Handle handle) const
+    {
+        return _impl->_result.version(handle);
+    }
+
+    uint64_t Parser::generation() const
+    {
+        return _impl->_result.generation();
+    }
+
+    int32_t Parser::as_int(Handle handle) const
+    {
+        return _impl->_result.as_int(handle);
+    }
+
+    uint32_t Parser::as_uint(Handle handle) const
+    {
+        return _impl->_result.as_uint(handle);
+    }
+
+    int64_t Parser::as_int64(Handle handle) const
+    {
+        return _impl->_result.as_int64(handle);
+    }
+
+    uint64_t Parser::as_uint64(Handle handle) const
+    {
+        return _impl->_result.as_uint64(handle);
+    }
+
+    double Parser::as_double(Handle handle) const
+    {
+        return _impl->_result.as_double(handle);
+    }
+
+    bool Parser::as_bool(Handle handle) const
+    {
+        return _impl->_result.as_bool(handle);
+    }
+
+    std::string Parser::as_string(Handle handle) const
+    {
+        return _impl->_result.as_string(handle);
+    }
+
+    View Parser::as_view(Handle handle) const
+    {
+        return _impl->_result.as_view(handle);
+    }
+
+    Range<View> Parser::as_strings(const std::string &name) const
+    {
+        return _impl->_result.as_strings(name);
+    }
+
+    Range<int64_t> Parser::as_int64s(const std::string &name) const
+    {
+        return _impl->_result.as_int64s(name);
+    }
+
+    Range<double> Parser::as_doubles(const std::string &name) const
+    {
+        return _impl->_result.as_doubles(name);
     }
 
-    const std::string &Parser::as_string(const std::string &name) const
+    Range<View> Parser::as_strings(Handle handle) const
     {
-        return _impl->find_option_by_long_name(name)->as_string();
+        return _impl->_result.as_strings(handle);
+    }
+
+    Range<int64_t> Parser::as_int64s(Handle handle) const
+    {
+        return _impl->_result.as_int64s(handle);
+    }
+
+    Range<double> Parser::as_doubles(Handle handle) const
+    {
+        return _impl->_result.as_doubles(handle);
     }
 
     std::string Parser::get_possible_options() const
     {
-        std::stringstream sstream;
+        return help(0);
+    }
 
-        std::left(sstream); // align left
+    std::string Parser::help(size_t width) const
+    {
+        return _impl->with_help(width, [](const std::string &text) { return text; });
+    }
 
-        constexpr int32_t MIN_TEXT_WIDTH = 8;
-        const int32_t SPACE_FOR_NAMES = MIN_TEXT_WIDTH + static_cast<int32_t>(_impl->_longest_option_name);
+    size_t Parser::write_help(char *buffer, size_t size, size_t width) const
+    {
+        return _impl->with_help(width, [buffer, size](const std::string &text) {
+            if (size > 0)
+            {
+                const size_t copied = std::min(text.size(), size - 1);
+                memcpy(buffer, text.data(), copied);
+                buffer[copied] = '\0';
+            }
 
-        for (const auto &opt: _impl->_options)
-        {
-            std::string short_long;
+            return text.size();
+        });
+    }
 
-            if (opt.short_name() != Option::SHORT_NOT_USED)
-                short_long += std::string("-") + opt.short_name() + ", ";
-            else
-                short_long += "    ";
+    bool Parser::print_help(FILE *file, size_t width) const
+    {
+        return _impl->with_help(width, [file](const std::string &text) {
+            return fwrite(text.data(), 1, text.size(), file) == text.size();
+        });
+    }
 
-            short_long += ("--" + opt.long_name());
+    bool Parser::print_help(int fd, size_t width) const
+    {
+        return _impl->with_help(width,
+                                [fd](const std::string &text) { return write_all(fd, text.data(), text.size()); });
+    }
 
-            sstream << " " << std::setw(SPACE_FOR_NAMES) << short_long << (opt.is_mandatory() ? "M " : "  ");
+    bool Parser::complete(int argc, const char *const *argv, int fd) const
+    {
+        if (argc < 2 || strcmp(argv[1], COMPLETE_OPTION) != 0)
+            return false;
 
-            sstream << opt.description();
+        std::string out;
+        _impl->complete(argv + 2, static_cast<size_t>(argc - 2), out);
+        write_all(fd, out.data(), out.size());
 
-            if (opt.is_optional())
-                sstream << " (default: " << opt.default_value() + ")";
+        return true;
+    }
 
-            sstream << std::endl;
-        }
+    size_t terminal_width(int fd)
+    {
+#if !defined(_WIN32)
+        struct winsize size = {};
+        if (ioctl(fd, TIOCGWINSZ, &size) == 0 && size.ws_col > 0)
+            return size.ws_col;
+#else
+        (void)fd;
+#endif
 
-        return sstream.str();
+        const char *columns = getenv("COLUMNS");
+        return (columns != nullptr) ? static_cast<size_t>(std::max(atoi(columns), 0)) : 0;
     }
 } // namespace Options
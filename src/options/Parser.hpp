@@ -1,13 +1,30 @@
 #pragma once
 
 #include <cstdint>
+#include <cstdio>
+#include <initializer_list>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "Completion.hpp"
+#include "Handle.hpp"
+#include "Parse_Result.hpp"
+#include "Range.hpp"
 #include "Validator.hpp"
+#include "View.hpp"
 
 namespace Options
 {
+    class Parser;
+
+    // Defines the options of a subcommand.
+    using subcommand_factory_t = void (*)(Parser &parser);
+
+    // Number of columns of the terminal of the file descriptor, or of the COLUMNS environment variable if it is not
+    // a terminal, or 0 if neither is known.
+    size_t terminal_width(int fd);
+
     /* Class Parser.
      *
      * This class defines expected and possible options passed to the program.
@@ -23,20 +40,56 @@ namespace Options
      * A short name is a single character and must be given with a single dash (e.g. short option
      * 'v' should be given as "-v").
      *
-     * Arguments to an option are expected after an empty character like so: "--mode something".
+     * Arguments to an option are expected after an empty character like so: "--mode something", or can be
+     * attached: "--mode=something" and "-msomething". Short flags can be bundled: "-abc" is "-a -b -c".
      *
      * Optional and mandatory options may have a validator, which simply returns true if a value
-     * that suppose to be used is correct.
+     * that suppose to be used is correct. A validator can receive either the text of the value or the
+     * already converted Value - see Validator for capturing callables and ready made range, set and
+     * pattern checks.
      *
      * When an object of this class during parsing parameters encounters standalone "--" then it stops
      * looking for defined parameters and treat everything after that as positional arguments. They
      * can be accessed via the api below.
      *
-     * Retrieving values of options is done by calling as_int, as_uint, as_double, as_bool or as_string.
-     * Retrieving not defined option will throw an exception.
+     * Retrieving values of options is done by calling as_int, as_uint, as_int64, as_uint64, as_double, as_bool
+     * or as_string.
+     * Retrieving not defined option will throw an exception (or abort when built without exceptions),
+     * try_get returns false instead.
+     *
+     * An option added by add_multiple collects all its values, e.g. "--input a --input b,c". They are
+     * retrieved by as_strings, as_int64s and as_doubles, which return contiguous arrays converted once
+     * while parsing.
+     *
+     * Every add_* method returns a handle of the option. The accessors also accept such a handle, in
+     * which case there is no name lookup at all. Passing an invalid handle is undefined behavior.
+     *
+     * Getting positional arguments is done by calling positional_count and positional, or positionals
+     * which returns all of them at once. Getting positional argument out of bounds will throw an exception.
+     *
+     * Strings (values and positional arguments) are returned as views. By default they refer to copies
+     * owned by the parser, in the zero-copy mode they refer directly to the argv strings.
      *
-     * Getting positional arguments is done by calling positional_count and positional.
-     * Getting positional argument out of bounds will throw an exception.
+     * Arguments can also be read from response files given as "@path" (see Response_File), which
+     * allows passing more arguments than the system limit for a command line.
+     *
+     * Values can also come from a configuration file and environment variables. Every value remembers
+     * its source and a source with a lower precedence never overrides a higher one:
+     * default < configuration file < environment variable < command line.
+     *
+     * A parser can have subcommands (like "git commit"), every one with its own options. The options of
+     * a subcommand are defined by its factory, which is called only when the subcommand is needed - when
+     * it is selected on the command line or its parser is requested. Everything after the name of the
+     * subcommand is parsed by the parser of the subcommand.
+     *
+     * A parser can be reused for many command lines: reset forgets the results of the previous parse
+     * while keeping the options and the allocated memory. After freeze no more options can be added,
+     * and clone_schema creates an independent parser with the same options.
+     *
+     * The parser itself holds only the options (the schema) and the results of the last call of
+     * parse(argc, argv). A frozen parser can also parse into a separate Parse_Result - that method
+     * does not modify the parser, so many threads can use a single frozen parser at the same time
+     * without any locking, every one with its own result.
      *
      * Extensive example of how to use this class is in example/example.cpp.
      */
@@ -52,35 +105,228 @@ namespace Options
         Parser &operator=(const Parser &) = delete;
         Parser &operator=(Parser &&) = delete;
 
-        void add_flag(const std::string &long_name, char short_name, const std::string &description);
+        Handle add_flag(const std::string &long_name, char short_name, const std::string &description);
+
+        Handle add_flag(const std::string &long_name, const std::string &description);
+
+        Handle add_optional(const std::string &long_name, char short_name, const std::string &description,
+                            const std::string &default_value, validator_t validator = nullptr);
 
-        void add_flag(const std::string &long_name, const std::string &description);
+        Handle add_optional(const std::string &long_name, const std::string &description,
+                            const std::string &default_value, validator_t validator = nullptr);
 
-        void add_optional(const std::string &long_name, char short_name, const std::string &description,
-                          const std::string &default_value, validator_t validator = nullptr);
+        Handle add_mandatory(const std::string &long_name, char short_name, const std::string &description,
+                             validator_t validator = nullptr);
 
-        void add_optional(const std::string &long_name, const std::string &description,
-                          const std::string &default_value, validator_t validator = nullptr);
+        Handle add_mandatory(const std::string &long_name, const std::string &description,
+                             validator_t validator = nullptr);
 
-        void add_mandatory(const std::string &long_name, char short_name, const std::string &description,
-                           validator_t validator = nullptr);
+        Handle add_optional(const std::string &long_name, char short_name, const std::string &description,
+                            const std::string &default_value, Validator validator);
 
-        void add_mandatory(const std::string &long_name, const std::string &description,
-                           validator_t validator = nullptr);
+        Handle add_optional(const std::string &long_name, const std::string &description,
+                            const std::string &default_value, Validator validator);
 
+        Handle add_mandatory(const std::string &long_name, char short_name, const std::string &description,
+                             Validator validator);
+
+        Handle add_mandatory(const std::string &long_name, const std::string &description,
+                             Validator validator);
+
+        // Adds an option which can be given many times, every value being added to the previous ones. A value can
+        // also be a list separated by the separator - unless it is Option::SEPARATOR_NOT_USED (0). Not given at all,
+        // the option has no values. A validator checks every value separately.
+        Handle add_multiple(const std::string &long_name, char short_name, const std::string &description,
+                            char separator = ',', Validator validator = {});
+
+        Handle add_multiple(const std::string &long_name, const std::string &description, char separator = ',',
+                            Validator validator = {});
+
+        // Adds an option taking one of the choices, every one identified by its position in the list. parse
+        // resolves the value to that id once, as_choice then returns it. Other values are rejected.
+        Handle add_choice(const std::string &long_name, char short_name, const std::string &description,
+                          std::initializer_list<const char *> choices, const std::string &default_value);
+
+        Handle add_choice(const std::string &long_name, const std::string &description,
+                          std::initializer_list<const char *> choices, const std::string &default_value);
+
+        // The choices of the option in the order of their ids, empty if it was not added by add_choice.
+        Range<View> choices(Handle handle) const;
+
+        // Returns a handle of the option with the given long name or an invalid handle if there is none.
+        Handle find(const std::string &name) const;
+
+        // When enabled, parse keeps references to the argv strings instead of copying values and positional
+        // arguments. The caller must then guarantee that argv outlives the parser. Disabled by default.
+        void set_zero_copy(bool enabled);
+
+        // When enabled, a long name can be abbreviated to any prefix which is unique, e.g. "--thr" for "--threshold".
+        // Exact names take precedence. The lookup table is built by freeze (or by parse if not frozen).
+        // Disabled by default.
+        void set_prefix_matching(bool enabled);
+
+        // When enabled, every "@path" string of argv is replaced by the arguments read from the file at path.
+        // The file is memory-mapped and split in place, its arguments are never copied. Disabled by default.
+        void set_response_files(bool enabled);
+
+        // Returns false if parsing failed, diagnostic then tells why and which argument caused it.
         bool parse(int argc, const char *const *argv, int start_idx = 1);
 
+        // Parses into the result, replacing its previous values. The parser must be frozen, otherwise an
+        // exception is thrown. Safe to call from many threads at the same time, as long as every one uses its
+        // own result.
+        bool parse(int argc, const char *const *argv, Parse_Result &result, int start_idx = 1) const;
+
+        // Applies options given at runtime in the command line form, e.g. {"--level", "high", "-v"}, on top of
+        // the current values. Only the given options are validated and set, and only if all of them are valid -
+        // otherwise nothing changes and diagnostic tells why. The values given to a multi-valued option replace
+        // its previous ones. Positional arguments and subcommands are not accepted. If changed is not null, it
+        // is filled with the options whose values differ now, in the order they were given. The texts are
+        // always copied (even with zero copy enabled) into a buffer of the option, which the next apply of the
+        // option reuses, so applying repeatedly does not grow the memory of the result.
+        bool apply(int count, const char *const *tokens, std::vector<Handle> *changed = nullptr);
+
+        // Applies into the result. The parser must be frozen, otherwise an exception is thrown.
+        bool apply(int count, const char *const *tokens, Parse_Result &result,
+                   std::vector<Handle> *changed = nullptr) const;
+
+        // Reads "key = value" lines of a configuration file (see Config_File), the keys being long names.
+        // Values from the command line take precedence over the ones from the file, regardless of the order
+        // of the calls. Mandatory options are not checked - parse does it.
+        bool parse_config(const std::string &path);
+
+        // Adds the values of the file to the result. As parsing into a result replaces its values, read the
+        // file after parse (or use set_config_option, which reads it during parse).
+        bool parse_config(const std::string &path, Parse_Result &result) const;
+
+        // Adds a subcommand. Its factory defines the options and is called at most once, when needed first.
+        void add_subcommand(const std::string &name, const std::string &description, subcommand_factory_t factory);
+
+        // Name of the subcommand selected by parse, or empty if there was none.
+        View subcommand_name() const;
+
+        // Returns the parser of the subcommand - with its values after parse. Throws if there is no such subcommand.
+        Parser &subcommand(const std::string &name);
+
+        // Binds the option to the environment variable, which parse then reads (after the command line).
+        // All the bound variables are read in one pass over the environment. If the variable is already
+        // bound to another option, the first binding wins.
+        void bind_env(Handle handle, const std::string &variable);
+
+        // Makes parse read the configuration file given by the value of the option (if not empty)
+        // right after the command line, so the file can provide mandatory options as well.
+        void set_config_option(Handle handle);
+
+        // Why the last parse failed (see Parse_Result::diagnostic). For a failure in a subcommand the option
+        // is one of the subcommand.
+        const Diagnostic &diagnostic() const;
+
+        // Forgets the values and positional arguments, keeping the options and the reserved memory.
+        void reset();
+
+        // Disallows adding more options - trying to do so throws an exception.
+        void freeze();
+        bool is_frozen() const;
+
+        // Creates a new parser with the same options (and frozen state), but no values.
+        std::unique_ptr<Parser> clone_schema() const;
+
+        // Snapshots of results, so a restarted program or a replayed job can skip parsing. A snapshot is a
+        // compact binary blob with the set values (texts with all their conversions and choices), their
+        // sources, the positional arguments and the subcommand, together with the fingerprint of the options.
+        //
+        // Loading converts and validates nothing again, it only copies the texts into the result. It fails
+        // with Error::Schema_Mismatch if the snapshot was saved by a parser with different options, and with
+        // Error::Malformed_Snapshot if it is damaged - then the result is left reset. Save only results of
+        // successful parses.
+        std::string save_snapshot() const;
+        std::string save_snapshot(const Parse_Result &result) const;
+        bool load_snapshot(const void *data, size_t size);
+        bool load_snapshot(const void *data, size_t size, Parse_Result &result) const; // requires a frozen parser
+
+        // Hash of the options (names, kinds, defaults and choices) and the names of the subcommands, stored in
+        // snapshots. Validators and environment variables are not part of it.
+        uint64_t schema_fingerprint() const;
+
         size_t positional_count() const;
-        const std::string &positional(size_t idx) const;
+        std::string positional(size_t idx) const;
+        View positional_view(size_t idx) const;
+        Range<View> positionals() const;
 
         int32_t as_int(const std::string &name) const;
         uint32_t as_uint(const std::string &name) const;
+        int64_t as_int64(const std::string &name) const;
+        uint64_t as_uint64(const std::string &name) const;
         double as_double(const std::string &name) const;
         bool as_bool(const std::string &name) const;
-        const std::string &as_string(const std::string &name) const;
+        std::string as_string(const std::string &name) const;
+        View as_view(const std::string &name) const; // no copy, see Parse_Result::as_view
+
+        // Set the value and return true, or return false if there is no such option.
+        bool try_get(const std::string &name, int32_t &value) const;
+        bool try_get(const std::string &name, uint32_t &value) const;
+        bool try_get(const std::string &name, int64_t &value) const;
+        bool try_get(const std::string &name, uint64_t &value) const;
+        bool try_get(const std::string &name, double &value) const;
+        bool try_get(const std::string &name, bool &value) const;
+        bool try_get(const std::string &name, View &value) const;
+
+        int32_t as_int(Handle handle) const;
+        uint32_t as_uint(Handle handle) const;
+        int64_t as_int64(Handle handle) const;
+        uint64_t as_uint64(Handle handle) const;
+        double as_double(Handle handle) const;
+        bool as_bool(Handle handle) const;
+        std::string as_string(Handle handle) const;
+        View as_view(Handle handle) const;
+
+        // Id of the choice of an option added by add_choice - see Parse_Result::as_choice.
+        int32_t as_choice(const std::string &name) const;
+        int32_t as_choice(Handle handle) const;
+
+        // Where the values come from - argv, a configuration file, the environment or the defaults.
+        Source source(const std::string &name) const;
+        Source source(Handle handle) const;
+        bool was_set(const std::string &name) const;
+        bool was_set(Handle handle) const;
+
+        // Counters of changes of the values - see Parse_Result::version and generation. Cheap enough to check
+        // in every iteration of a loop, instead of reading and converting the values again.
+        uint64_t version(const std::string &name) const;
+        uint64_t version(Handle handle) const;
+        uint64_t generation() const;
+
+        // Values of a multi-valued option - see Parse_Result.
+        Range<View> as_strings(const std::string &name) const;
+        Range<int64_t> as_int64s(const std::string &name) const;
+        Range<double> as_doubles(const std::string &name) const;
 
+        Range<View> as_strings(Handle handle) const;
+        Range<int64_t> as_int64s(Handle handle) const;
+        Range<double> as_doubles(Handle handle) const;
+
+        // Answers a query of a completion script (see completion_script): if argv[1] is "--__complete", prints
+        // the completions of the last of the following words to the file descriptor and returns true - the
+        // program should then exit. Call it right after defining the options, before anything else.
+        bool complete(int argc, const char *const *argv, int fd = 1) const;
+
+        static constexpr const char *COMPLETE_OPTION = "--__complete";
+
+        // Help text listing the options and subcommands, the same as help(0).
         std::string get_possible_options() const;
 
+        // Help text with the descriptions wrapped to fit the width (e.g. terminal_width), 0 does not wrap.
+        // The text is rendered once and kept until the options change or it is requested for another width.
+        std::string help(size_t width = 0) const;
+
+        // Copies the help text into the buffer like snprintf - at most size - 1 characters and a NUL - and
+        // returns its full length, so a too small buffer can be detected.
+        size_t write_help(char *buffer, size_t size, size_t width = 0) const;
+
+        // Writes the help text with a single write call, without any copies. Returns false on an error.
+        bool print_help(FILE *file, size_t width = 0) const;
+        bool print_help(int fd, size_t width = 0) const;
+
     private:
         struct Impl;
         std::unique_ptr<Impl> _impl;
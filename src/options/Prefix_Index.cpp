@@ -0,0 +1,46 @@
+#include <algorithm>
+#include <cstring>
+
+#include "Prefix_Index.hpp"
+
+namespace Options
+{
+    constexpr uint32_t Prefix_Index::NOT_FOUND;
+    constexpr uint32_t Prefix_Index::AMBIGUOUS;
+
+    void Prefix_Index::add(View name, uint32_t position)
+    {
+        _entries.push_back({name, position});
+    }
+
+    void Prefix_Index::build()
+    {
+        std::sort(_entries.begin(), _entries.end(), [](const Entry &lhs, const Entry &rhs) {
+            return strcmp(lhs.name.c_str(), rhs.name.c_str()) < 0;
+        });
+    }
+
+    uint32_t Prefix_Index::find(const char *prefix, size_t size) const
+    {
+        const size_t found = first(prefix, size);
+
+        if (found == _entries.size() || !starts_with(_entries[found].name, prefix, size))
+            return NOT_FOUND;
+
+        const size_t next = found + 1;
+        if (next != _entries.size() && starts_with(_entries[next].name, prefix, size))
+            return AMBIGUOUS;
+
+        return _entries[found].position;
+    }
+
+    size_t Prefix_Index::first(const char *prefix, size_t size) const
+    {
+        const auto LESS_THAN_PREFIX = [size](const Entry &entry, const char *value) {
+            return strncmp(entry.name.c_str(), value, size) < 0;
+        };
+
+        return static_cast<size_t>(std::lower_bound(_entries.cbegin(), _entries.cend(), prefix, LESS_THAN_PREFIX) -
+                                   _entries.cbegin());
+    }
+} // namespace Options
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "View.hpp"
+
+namespace Options
+{
+    /* Lookup of long names by their unique prefixes, like "--thr" for "--threshold".
+     *
+     * The names are kept sorted, so all the names starting with a prefix are next to each other: the
+     * first one is found by a binary search and the prefix is unique if the following one does not
+     * start with it as well. The index is built once, when the set of names is complete.
+     */
+    class Prefix_Index
+    {
+    public:
+        static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+        static constexpr uint32_t AMBIGUOUS = UINT32_MAX - 1;
+
+        // Adds a name, which must outlive the index. Call build after adding all the names.
+        void add(View name, uint32_t position);
+        void build();
+
+        // Returns the position of the only name starting with the prefix, NOT_FOUND or AMBIGUOUS.
+        uint32_t find(const char *prefix, size_t size) const;
+
+        // Calls the function with the name and position of every name starting with the prefix, in sorted order.
+        template <typename Function>
+        void for_each(const char *prefix, size_t size, Function function) const
+        {
+            for (size_t i = first(prefix, size); i < _entries.size(); ++i)
+            {
+                if (!starts_with(_entries[i].name, prefix, size))
+                    break;
+
+                function(_entries[i].name, _entries[i].position);
+            }
+        }
+
+        size_t size() const { return _entries.size(); }
+        void clear() { _entries.clear(); }
+
+    private:
+        struct Entry
+        {
+            View name;
+            uint32_t position;
+        };
+
+        // Returns the index of the first entry not less than the prefix.
+        size_t first(const char *prefix, size_t size) const;
+
+        static bool starts_with(View name, const char *prefix, size_t size)
+        {
+            return name.size() >= size && memcmp(name.data(), prefix, size) == 0;
+        }
+
+        std::vector<Entry> _entries;
+    };
+} // namespace Options
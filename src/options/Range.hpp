@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Options
+{
+    /* Read only view of a contiguous array of elements, usable in range based for loops. */
+    template <typename T>
+    class Range
+    {
+    public:
+        Range() = default;
+        Range(const T *begin, size_t size) : _begin{begin}, _size{size} {}
+
+        const T *begin() const { return _begin; }
+        const T *end() const { return _begin + _size; }
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        const T &operator[](size_t idx) const { return _begin[idx]; }
+
+    private:
+        const T *_begin = nullptr;
+        size_t _size = 0;
+    };
+} // namespace Options
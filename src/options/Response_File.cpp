@@ -0,0 +1,55 @@
+#include "Response_File.hpp"
+
+namespace Options
+{
+    namespace
+    {
+        bool is_space(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+        }
+    } // namespace
+
+    const char *Response_File::next()
+    {
+        while (_position < _size && is_space(_data[_position]))
+            ++_position;
+
+        if (_position >= _size)
+            return nullptr;
+
+        char *token = _data + _position;
+        char *write = token;
+        char quote = '\0';
+
+        for (; _position < _size; ++_position)
+        {
+            const char c = _data[_position];
+
+            if (quote == '\0' && is_space(c))
+                break;
+
+            if (c == quote)
+                quote = '\0';
+            else if (quote == '\0' && (c == '"' || c == '\''))
+                quote = c;
+            else if (c == '\\' && quote != '\'' && _position + 1 < _size)
+                *write++ = _data[++_position];
+            else
+                *write++ = c;
+        }
+
+        if (quote != '\0')
+        {
+            _malformed = true;
+            _position = _size;
+            return nullptr;
+        }
+
+        // the delimiter (or the byte after the contents) becomes the terminator
+        *write = '\0';
+        _position += 1;
+
+        return token;
+    }
+} // namespace Options
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Mapped_File.hpp"
+
+namespace Options
+{
+    /* Tokenizer of a response file - a file with command line arguments given on the command line as "@path".
+     *
+     * The tokens are separated by white spaces, single and double quotes group characters (including
+     * white spaces) and a backslash outside single quotes escapes the next character. The file is split
+     * in place: removing the quotes and escapes only moves characters towards the beginning of a token
+     * and a NUL character is written in place of its delimiter, so the tokens need no copies and the
+     * file is never read as a whole into a container.
+     *
+     * The tokens are valid as long as the file lives.
+     */
+    class Response_File
+    {
+    public:
+        Response_File() = default; // without any tokens
+        explicit Response_File(Mapped_File &file) : _data{file.data()}, _size{file.size()} {}
+
+        // Returns the next NUL-terminated token or nullptr if there are no more, or if the token has an
+        // unterminated quote - then the file is malformed.
+        const char *next();
+
+        bool malformed() const { return _malformed; }
+
+    private:
+        char *_data = nullptr;
+        size_t _size = 0;
+        size_t _position = 0;
+        bool _malformed = false;
+    };
+} // namespace Options
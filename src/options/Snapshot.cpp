@@ -0,0 +1,119 @@
+#include "Snapshot.hpp"
+
+#include <cstring>
+
+namespace Options
+{
+    void Snapshot_Writer::u32(uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            u8(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    void Snapshot_Writer::u64(uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+            u8(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    void Snapshot_Writer::f64(double value)
+    {
+        uint64_t bits = 0;
+        memcpy(&bits, &value, sizeof(bits));
+        u64(bits);
+    }
+
+    void Snapshot_Writer::text(View value)
+    {
+        u32(static_cast<uint32_t>(value.size()));
+        _out.append(value.data(), value.size());
+    }
+
+    const char *Snapshot_Reader::take(size_t size)
+    {
+        if (_failed || size > _size - _position)
+        {
+            _failed = true;
+            return nullptr;
+        }
+
+        const char *result = _data + _position;
+        _position += size;
+        return result;
+    }
+
+    uint8_t Snapshot_Reader::u8()
+    {
+        const char *bytes = take(1);
+        return (bytes != nullptr) ? static_cast<uint8_t>(bytes[0]) : 0;
+    }
+
+    uint32_t Snapshot_Reader::u32()
+    {
+        const char *bytes = take(4);
+        if (bytes == nullptr)
+            return 0;
+
+        uint32_t result = 0;
+        for (int i = 0; i < 4; ++i)
+            result |= static_cast<uint32_t>(static_cast<uint8_t>(bytes[i])) << (8 * i);
+
+        return result;
+    }
+
+    uint64_t Snapshot_Reader::u64()
+    {
+        const char *bytes = take(8);
+        if (bytes == nullptr)
+            return 0;
+
+        uint64_t result = 0;
+        for (int i = 0; i < 8; ++i)
+            result |= static_cast<uint64_t>(static_cast<uint8_t>(bytes[i])) << (8 * i);
+
+        return result;
+    }
+
+    double Snapshot_Reader::f64()
+    {
+        const uint64_t bits = u64();
+
+        double result = 0.0;
+        memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    View Snapshot_Reader::text()
+    {
+        const uint32_t size = u32();
+
+        const char *data = take(size);
+        return (data != nullptr) ? View(data, size) : View();
+    }
+
+    void Fingerprint::add(View text)
+    {
+        add(static_cast<uint64_t>(text.size()));
+        add_bytes(text.data(), text.size());
+    }
+
+    void Fingerprint::add(uint64_t value)
+    {
+        char bytes[8];
+        for (int i = 0; i < 8; ++i)
+            bytes[i] = static_cast<char>(value >> (8 * i));
+
+        add_bytes(bytes, sizeof(bytes));
+    }
+
+    void Fingerprint::add_bytes(const char *data, size_t size)
+    {
+        constexpr uint64_t PRIME = 1099511628211ULL;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            _hash ^= static_cast<unsigned char>(data[i]);
+            _hash *= PRIME;
+        }
+    }
+} // namespace Options
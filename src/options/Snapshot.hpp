@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "View.hpp"
+
+namespace Options
+{
+    /* Binary encoding of snapshots of parse results (see Parser::save_snapshot).
+     *
+     * Numbers are written in little-endian order with fixed sizes, doubles by their bits and texts as
+     * their size followed by the characters, so a snapshot can be read on any machine.
+     */
+    class Snapshot_Writer
+    {
+    public:
+        explicit Snapshot_Writer(std::string &out) : _out(out) {}
+
+        void u8(uint8_t value) { _out += static_cast<char>(value); }
+        void u32(uint32_t value);
+        void u64(uint64_t value);
+        void f64(double value);
+        void text(View value);
+
+    private:
+        std::string &_out;
+    };
+
+    /* Reader of what Snapshot_Writer wrote. Reading past the end fails and so does everything after it,
+     * so the checks can be done once after reading a group of fields.
+     */
+    class Snapshot_Reader
+    {
+    public:
+        Snapshot_Reader(const void *data, size_t size) : _data{static_cast<const char *>(data)}, _size{size} {}
+
+        uint8_t u8();
+        uint32_t u32();
+        uint64_t u64();
+        double f64();
+
+        // The view refers to the read data and is not NUL-terminated.
+        View text();
+
+        bool failed() const { return _failed; }
+        bool at_end() const { return _position == _size; }
+
+    private:
+        // Returns the next size bytes, or nullptr if there are not so many.
+        const char *take(size_t size);
+
+        const char *_data;
+        size_t _size;
+        size_t _position = 0;
+        bool _failed = false;
+    };
+
+    // 64-bit FNV-1a hash of a sequence of fields - a text is hashed with its size, so "ab","c" differs from "a","bc".
+    class Fingerprint
+    {
+    public:
+        void add(View text);
+        void add(uint64_t value);
+
+        uint64_t value() const { return _hash; }
+
+    private:
+        void add_bytes(const char *data, size_t size);
+
+        uint64_t _hash = 14695981039346656037ULL;
+    };
+} // namespace Options
@@ -0,0 +1,471 @@
+#pragma once
+
+#if __cplusplus < 201703L
+    #error "options/Static_Parser.hpp requires C++17 - link with the options_static target"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Converters.hpp"
+#include "Range.hpp"
+#include "View.hpp"
+
+namespace Options
+{
+    namespace Static
+    {
+        /* Compile time schema of options.
+         *
+         * When the set of options is known at compile time, it can be declared as a constexpr table:
+         *
+         *     constexpr Options::Static::Spec SPECS[] = {
+         *         Options::Static::mandatory<const char *>("config", 'c', "Configuration file"),
+         *         Options::Static::optional("count", "Number of iterations", 10),
+         *         Options::Static::flag("verbose", 'v', "Verbose"),
+         *     };
+         *
+         *     using Args = Options::Static::Parser<SPECS>;
+         *
+         * From such a table Parser generates the name lookup tables and a tuple holding a typed value
+         * for every option, everything at compile time. There is no registration at runtime and getting
+         * a value is a load of a member:
+         *
+         *     Args args;
+         *     if (args.parse(argc, argv))
+         *         int64_t count = args.get<Args::index_of("count")>();
+         *
+         * Options are given as "--name value" or "-n value", flags as "--name" or "-n", and everything
+         * after "--" is positional. The shorthands of Options::Parser - "--name=value", "-nvalue", bundled
+         * short flags and prefixes of long names - are not supported. A bool option which is not a flag
+         * takes "true", "false", "1" or "0".
+         *
+         * Values are converted while parsing with the strict converters, so an invalid number makes the
+         * parsing fail. Every parse starts from the defaults. Strings are views of the argv strings, so
+         * argv must outlive the parser.
+         */
+
+        enum class Kind
+        {
+            Flag,   // bool
+            Int,    // int64_t
+            Uint,   // uint64_t
+            Double, // double
+            String  // View
+        };
+
+        enum class Presence
+        {
+            Flag,
+            Optional,
+            Mandatory
+        };
+
+        struct Spec
+        {
+            const char *long_name;
+            char short_name;
+            const char *description;
+            Kind kind;
+            Presence presence;
+
+            int64_t default_int;
+            uint64_t default_uint;
+            double default_double;
+            const char *default_string;
+            bool default_bool;
+        };
+
+        constexpr char SHORT_NOT_USED = 0;
+
+        namespace Detail
+        {
+            template <typename T>
+            constexpr Kind kind_of()
+            {
+                if constexpr (std::is_same<T, bool>::value)
+                    return Kind::Flag;
+                else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value)
+                    return Kind::Int;
+                else if constexpr (std::is_integral<T>::value)
+                    return Kind::Uint;
+                else if constexpr (std::is_floating_point<T>::value)
+                    return Kind::Double;
+                else
+                {
+                    static_assert(std::is_convertible<T, const char *>::value, "unsupported type of an option");
+                    return Kind::String;
+                }
+            }
+
+            template <Kind K>
+            struct Type;
+
+            template <>
+            struct Type<Kind::Flag>
+            {
+                using type = bool;
+            };
+
+            template <>
+            struct Type<Kind::Int>
+            {
+                using type = int64_t;
+            };
+
+            template <>
+            struct Type<Kind::Uint>
+            {
+                using type = uint64_t;
+            };
+
+            template <>
+            struct Type<Kind::Double>
+            {
+                using type = double;
+            };
+
+            template <>
+            struct Type<Kind::String>
+            {
+                using type = View;
+            };
+
+            template <typename T>
+            constexpr Spec make(const char *long_name, char short_name, const char *description, Presence presence,
+                                T default_value)
+            {
+                Spec spec{long_name, short_name, description, kind_of<T>(), presence, 0, 0, 0.0, "", false};
+
+                if constexpr (kind_of<T>() == Kind::Flag)
+                    spec.default_bool = default_value;
+                else if constexpr (kind_of<T>() == Kind::Int)
+                    spec.default_int = default_value;
+                else if constexpr (kind_of<T>() == Kind::Uint)
+                    spec.default_uint = default_value;
+                else if constexpr (kind_of<T>() == Kind::Double)
+                    spec.default_double = default_value;
+                else if constexpr (kind_of<T>() == Kind::String)
+                    spec.default_string = (default_value != nullptr) ? default_value : "";
+
+                return spec;
+            }
+
+            constexpr size_t length(const char *text)
+            {
+                size_t result = 0;
+                while (text[result] != '\0')
+                    ++result;
+                return result;
+            }
+
+            constexpr bool equals(const char *lhs, const char *rhs, size_t rhs_size)
+            {
+                for (size_t i = 0; i < rhs_size; ++i)
+                    if (lhs[i] != rhs[i] || lhs[i] == '\0')
+                        return false;
+
+                return lhs[rhs_size] == '\0';
+            }
+
+            // Accepts only "true", "false", "1" and "0".
+            constexpr bool parse_bool(const char *text, size_t size, bool &value)
+            {
+                if (equals("true", text, size) || equals("1", text, size))
+                    value = true;
+                else if (equals("false", text, size) || equals("0", text, size))
+                    value = false;
+                else
+                    return false;
+
+                return true;
+            }
+
+            // FNV-1a, the same as used by Name_Index
+            constexpr uint32_t hash(const char *name, size_t size)
+            {
+                uint32_t result = 2166136261U;
+
+                for (size_t i = 0; i < size; ++i)
+                {
+                    result ^= static_cast<unsigned char>(name[i]);
+                    result *= 16777619U;
+                }
+
+                return result;
+            }
+
+            constexpr size_t table_size(size_t count)
+            {
+                size_t result = 1;
+                while (result < count * 2)
+                    result *= 2;
+                return result;
+            }
+        } // namespace Detail
+
+        constexpr Spec flag(const char *long_name, char short_name, const char *description)
+        {
+            return Detail::make(long_name, short_name, description, Presence::Flag, false);
+        }
+
+        constexpr Spec flag(const char *long_name, const char *description)
+        {
+            return flag(long_name, SHORT_NOT_USED, description);
+        }
+
+        template <typename T>
+        constexpr Spec optional(const char *long_name, char short_name, const char *description, T default_value)
+        {
+            return Detail::make(long_name, short_name, description, Presence::Optional, default_value);
+        }
+
+        template <typename T>
+        constexpr Spec optional(const char *long_name, const char *description, T default_value)
+        {
+            return optional(long_name, SHORT_NOT_USED, description, default_value);
+        }
+
+        template <typename T>
+        constexpr Spec mandatory(const char *long_name, char short_name, const char *description)
+        {
+            return Detail::make(long_name, short_name, description, Presence::Mandatory, T{});
+        }
+
+        template <typename T>
+        constexpr Spec mandatory(const char *long_name, const char *description)
+        {
+            return mandatory<T>(long_name, SHORT_NOT_USED, description);
+        }
+
+        template <const auto &SPECS>
+        class Parser
+        {
+            static constexpr size_t COUNT = std::size(SPECS);
+            static constexpr size_t NOT_FOUND = COUNT;
+
+            template <size_t I>
+            using type_at = typename Detail::Type<SPECS[I].kind>::type;
+
+            template <size_t... I>
+            static auto make_values(std::index_sequence<I...>) -> std::tuple<type_at<I>...>;
+
+            using Values = decltype(make_values(std::make_index_sequence<COUNT>{}));
+
+        public:
+            // Position of the option with the given long name, usable as an argument of get and was_set.
+            static constexpr size_t index_of(const char *name)
+            {
+                for (size_t i = 0; i < COUNT; ++i)
+                    if (Detail::equals(SPECS[i].long_name, name, Detail::length(name)))
+                        return i;
+
+                return NOT_FOUND;
+            }
+
+            Parser() : _values{make_defaults(std::make_index_sequence<COUNT>{})} {}
+
+            bool parse(int argc, const char *const *argv, int start_idx = 1)
+            {
+                _values = make_defaults(std::make_index_sequence<COUNT>{});
+                _was_set = {};
+                _positionals = {};
+
+                int pos = start_idx;
+
+                while (pos < argc)
+                {
+                    const char *token = argv[pos];
+
+                    if (token[0] == '-' && token[1] == '-' && token[2] == '\0')
+                    {
+                        _positionals = {argv + pos + 1, static_cast<size_t>(argc - pos - 1)};
+                        break;
+                    }
+
+                    const size_t idx = find(token);
+                    if (idx == NOT_FOUND)
+                        return false;
+
+                    const char *value = "true";
+
+                    if (SPECS[idx].presence != Presence::Flag)
+                    {
+                        pos += 1;
+                        if (pos >= argc) // value not found
+                            return false;
+
+                        value = argv[pos];
+                    }
+
+                    if (!SETTERS[idx](_values, value))
+                        return false;
+
+                    _was_set[idx] = true;
+                    pos += 1;
+                }
+
+                for (size_t i = 0; i < COUNT; ++i)
+                    if (SPECS[i].presence == Presence::Mandatory && !_was_set[i])
+                        return false;
+
+                return true;
+            }
+
+            template <size_t I>
+            const type_at<I> &get() const
+            {
+                static_assert(I < COUNT, "unknown option");
+                return std::get<I>(_values);
+            }
+
+            template <size_t I>
+            bool was_set() const
+            {
+                static_assert(I < COUNT, "unknown option");
+                return _was_set[I];
+            }
+
+            Range<const char *> positionals() const { return _positionals; }
+
+        private:
+            template <size_t I>
+            static constexpr type_at<I> default_of()
+            {
+                constexpr Spec SPEC = SPECS[I];
+
+                if constexpr (SPEC.kind == Kind::Flag)
+                    return SPEC.default_bool;
+                else if constexpr (SPEC.kind == Kind::Int)
+                    return SPEC.default_int;
+                else if constexpr (SPEC.kind == Kind::Uint)
+                    return SPEC.default_uint;
+                else if constexpr (SPEC.kind == Kind::Double)
+                    return SPEC.default_double;
+                else
+                    return View(SPEC.default_string, Detail::length(SPEC.default_string));
+            }
+
+            template <size_t... I>
+            static constexpr Values make_defaults(std::index_sequence<I...>)
+            {
+                return Values{default_of<I>()...};
+            }
+
+            // Converts and stores the value of the option I.
+            template <size_t I>
+            static bool set(Values &values, const char *text)
+            {
+                constexpr Kind KIND = SPECS[I].kind;
+                auto &value = std::get<I>(values);
+                const size_t size = Detail::length(text);
+
+                if constexpr (KIND == Kind::Flag && SPECS[I].presence == Presence::Flag)
+                    value = true;
+                else if constexpr (KIND == Kind::Flag)
+                    return Detail::parse_bool(text, size, value);
+                else if constexpr (KIND == Kind::Int)
+                    return parse_int64(text, size, value) == Conversion::Ok;
+                else if constexpr (KIND == Kind::Uint)
+                    return parse_uint64(text, size, value) == Conversion::Ok;
+                else if constexpr (KIND == Kind::Double)
+                    return parse_double(text, size, value) == Conversion::Ok;
+                else
+                    value = View(text, size);
+
+                return true;
+            }
+
+            using setter_t = bool (*)(Values &, const char *);
+
+            template <size_t... I>
+            static constexpr std::array<setter_t, COUNT> make_setters(std::index_sequence<I...>)
+            {
+                return {{&set<I>...}};
+            }
+
+            static constexpr std::array<uint32_t, 256> make_short_table()
+            {
+                std::array<uint32_t, 256> table{};
+
+                for (auto &entry: table)
+                    entry = NOT_FOUND;
+
+                for (size_t i = 0; i < COUNT; ++i)
+                {
+                    auto &entry = table[static_cast<unsigned char>(SPECS[i].short_name)];
+                    if (SPECS[i].short_name != SHORT_NOT_USED && entry == NOT_FOUND)
+                        entry = static_cast<uint32_t>(i);
+                }
+
+                return table;
+            }
+
+            static constexpr size_t LONG_TABLE_SIZE = Detail::table_size(COUNT);
+
+            // open addressing hash table with linear probing, the first definition of a name wins
+            static constexpr std::array<uint32_t, LONG_TABLE_SIZE> make_long_table()
+            {
+                std::array<uint32_t, LONG_TABLE_SIZE> table{};
+
+                for (auto &entry: table)
+                    entry = NOT_FOUND;
+
+                for (size_t i = 0; i < COUNT; ++i)
+                {
+                    const char *name = SPECS[i].long_name;
+                    const size_t size = Detail::length(name);
+
+                    size_t slot = Detail::hash(name, size) & (LONG_TABLE_SIZE - 1);
+                    while (table[slot] != NOT_FOUND && !Detail::equals(SPECS[table[slot]].long_name, name, size))
+                        slot = (slot + 1) & (LONG_TABLE_SIZE - 1);
+
+                    if (table[slot] == NOT_FOUND)
+                        table[slot] = static_cast<uint32_t>(i);
+                }
+
+                return table;
+            }
+
+            static constexpr std::array<setter_t, COUNT> SETTERS = make_setters(std::make_index_sequence<COUNT>{});
+            static constexpr std::array<uint32_t, 256> SHORT_TABLE = make_short_table();
+            static constexpr std::array<uint32_t, LONG_TABLE_SIZE> LONG_TABLE = make_long_table();
+
+            // Returns the position of the option given with dashes or NOT_FOUND.
+            static size_t find(const char *token)
+            {
+                if (token[0] != '-')
+                    return NOT_FOUND;
+
+                if (token[1] != '-')
+                {
+                    if (token[1] == '\0' || token[2] != '\0')
+                        return NOT_FOUND;
+
+                    return SHORT_TABLE[static_cast<unsigned char>(token[1])];
+                }
+
+                const char *name = token + 2;
+                const size_t size = Detail::length(name);
+
+                for (size_t slot = Detail::hash(name, size) & (LONG_TABLE_SIZE - 1);;
+                     slot = (slot + 1) & (LONG_TABLE_SIZE - 1))
+                {
+                    const uint32_t idx = LONG_TABLE[slot];
+
+                    if (idx == NOT_FOUND || Detail::equals(SPECS[idx].long_name, name, size))
+                        return idx;
+                }
+            }
+
+            Values _values;
+            std::array<bool, COUNT> _was_set{};
+            Range<const char *> _positionals;
+        };
+    } // namespace Static
+} // namespace Options
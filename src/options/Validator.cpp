@@ -0,0 +1,142 @@
+#include <cstring>
+
+#include "Name_Index.hpp"
+#include "Validator.hpp"
+
+namespace Options
+{
+    namespace
+    {
+        // Matches a set like "[a-z_]" at the pattern, moving it past the set. An unterminated set
+        // matches the '[' character itself.
+        bool matches_set(const char *&pattern, const char *end, char c)
+        {
+            const char *p = pattern + 1;
+            const bool negated = (p < end && (*p == '!' || *p == '^'));
+            if (negated)
+                ++p;
+
+            bool found = false;
+            bool first = true;
+
+            for (; p < end && (*p != ']' || first); ++p, first = false)
+            {
+                if (*p == '\\' && p + 1 < end)
+                    ++p;
+
+                if (p + 2 < end && p[1] == '-' && p[2] != ']')
+                {
+                    found = found || (c >= p[0] && c <= p[2]);
+                    p += 2;
+                }
+                else
+                    found = found || (c == *p);
+            }
+
+            if (p == end) // not terminated
+            {
+                ++pattern;
+                return c == '[';
+            }
+
+            pattern = p + 1;
+            return found != negated;
+        }
+
+        // Iterative glob matching - after a mismatch it backtracks only to the last '*', which is enough,
+        // as a later '*' can match everything an earlier one could.
+        bool glob(const char *pattern, const char *pattern_end, const char *text, const char *text_end)
+        {
+            const char *star = nullptr;
+            const char *star_text = nullptr;
+
+            while (text < text_end)
+            {
+                if (pattern < pattern_end && *pattern == '*')
+                {
+                    star = ++pattern;
+                    star_text = text;
+                    continue;
+                }
+
+                if (pattern < pattern_end)
+                {
+                    const char *next = pattern;
+                    bool matched = false;
+
+                    if (*pattern == '?')
+                    {
+                        matched = true;
+                        ++next;
+                    }
+                    else if (*pattern == '[')
+                        matched = matches_set(next, pattern_end, *text);
+                    else
+                    {
+                        if (*next == '\\' && next + 1 < pattern_end)
+                            ++next;
+                        matched = (*next++ == *text);
+                    }
+
+                    if (matched)
+                    {
+                        pattern = next;
+                        ++text;
+                        continue;
+                    }
+                }
+
+                if (star == nullptr)
+                    return false;
+
+                pattern = star;
+                text = ++star_text;
+            }
+
+            while (pattern < pattern_end && *pattern == '*')
+                ++pattern;
+
+            return pattern == pattern_end;
+        }
+    } // namespace
+
+    Validator int_range(int64_t min, int64_t max)
+    {
+        return [min, max](const Value &value) {
+            return value.is_int64() && value.as_int64() >= min && value.as_int64() <= max;
+        };
+    }
+
+    Validator uint_range(uint64_t min, uint64_t max)
+    {
+        return [min, max](const Value &value) {
+            return value.is_uint64() && value.as_uint64() >= min && value.as_uint64() <= max;
+        };
+    }
+
+    Validator double_range(double min, double max)
+    {
+        return [min, max](const Value &value) {
+            return value.is_double() && value.as_double() >= min && value.as_double() <= max;
+        };
+    }
+
+    Validator one_of(std::initializer_list<const char *> allowed)
+    {
+        Name_Index set;
+        for (const char *text: allowed)
+            set.add_long(text, strlen(text), 0);
+
+        return [set](const Value &value) {
+            return set.find_long(value.as_string().data(), value.as_string().size()) != Name_Index::NOT_FOUND;
+        };
+    }
+
+    Validator matches(const std::string &pattern)
+    {
+        return [pattern](const Value &value) {
+            const View text = value.as_string();
+            return glob(pattern.data(), pattern.data() + pattern.size(), text.data(), text.data() + text.size());
+        };
+    }
+} // namespace Options
@@ -1,8 +1,87 @@
 #pragma once
 
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
+
+#include "Value.hpp"
 
 namespace Options
 {
     using validator_t = bool (*)(const std::string &);
-}
+
+    // Validator receiving the value already converted, so it does not need to parse the text again.
+    using value_validator_t = bool (*)(const Value &);
+
+    /* Validator of a converted value - a plain function, any callable (also a capturing lambda) taking
+     * const Value &, or one of the ready made checks below: int_range, uint_range, double_range, one_of
+     * and matches.
+     *
+     * The ready made checks prepare everything when they are created, so checking a value is just a
+     * comparison or a lookup, without parsing the text again and without allocation. Copies of a
+     * validator share the callable. A default constructed validator accepts everything.
+     */
+    class Validator
+    {
+    public:
+        Validator() = default;
+        Validator(value_validator_t function) : _function{function} {} // NOLINT - implicit on purpose
+
+        template <typename Function, typename = typename std::enable_if<
+                                         !std::is_same<typename std::decay<Function>::type, Validator>::value &&
+                                         std::is_convertible<decltype(std::declval<const Function &>()(
+                                                                 std::declval<const Value &>())),
+                                                             bool>::value>::type>
+        Validator(Function function) // NOLINT - implicit on purpose
+        {
+            init(std::move(function), std::is_convertible<Function, value_validator_t>{});
+        }
+
+        bool operator()(const Value &value) const
+        {
+            if (_call != nullptr)
+                return _call(_callable.get(), value);
+
+            return _function == nullptr || _function(value);
+        }
+
+        // False for a default constructed validator.
+        explicit operator bool() const { return _call != nullptr || _function != nullptr; }
+
+    private:
+        // a lambda without captures is kept as a plain function
+        template <typename Function>
+        void init(Function function, std::true_type)
+        {
+            _function = function;
+        }
+
+        template <typename Function>
+        void init(Function function, std::false_type)
+        {
+            _callable = std::make_shared<Function>(std::move(function));
+            _call = [](const void *callable, const Value &value) -> bool {
+                return (*static_cast<const Function *>(callable))(value);
+            };
+        }
+
+        value_validator_t _function = nullptr;
+        std::shared_ptr<const void> _callable;
+        bool (*_call)(const void *callable, const Value &value) = nullptr;
+    };
+
+    // Accepts valid numbers (see Value) in the range <min..max>.
+    Validator int_range(int64_t min, int64_t max);
+    Validator uint_range(uint64_t min, uint64_t max);
+    Validator double_range(double min, double max);
+
+    // Accepts only the given strings. They are put into a hash set, so the check is a single lookup.
+    Validator one_of(std::initializer_list<const char *> allowed);
+
+    // Accepts values matching the glob pattern: '*' matches any text, '?' any character, "[abc]" and
+    // "[a-z]" a character of a set ("[!abc]" of none), and '\' escapes the next character.
+    Validator matches(const std::string &pattern);
+} // namespace Options
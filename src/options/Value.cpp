@@ -0,0 +1,30 @@
+#include "Value.hpp"
+#include "Converters.hpp"
+
+namespace Options
+{
+    Value::Value(View text)
+    {
+        assign(text);
+    }
+
+    void Value::assign(View text)
+    {
+        _text = text;
+
+        _boolean = Options::as_bool(text.c_str());
+
+        // as_int agrees with the validators, which check the strict value (hexadecimal, octal, suffixes)
+        _int64 = 0;
+        _is_int64 = parse_int64(text.data(), text.size(), _int64) == Conversion::Ok;
+        _integer = _is_int64 ? static_cast<int32_t>(_int64) : Options::as_int(text.c_str());
+
+        _uint64 = 0;
+        _is_uint64 = parse_uint64(text.data(), text.size(), _uint64) == Conversion::Ok;
+
+        // a valid number converts the same way strictly, only the rest needs the lenient conversion
+        _is_double = parse_double(text.data(), text.size(), _real) == Conversion::Ok;
+        if (!_is_double)
+            _real = Options::as_double(text.c_str());
+    }
+} // namespace Options
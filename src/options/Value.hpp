@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+#include "View.hpp"
+
+namespace Options
+{
+    class Parser;
+
+    /* Textual value of an option together with its conversions.
+     *
+     * The text is converted to all the supported types once, when it is assigned, so reading a value
+     * of any type later is just a load. The conversions are the same as the ones in Converters.hpp - as_int64
+     * and as_uint64 are strict, so they are 0 for anything that is not a valid number, and as_int and as_uint
+     * fall back to the lenient conversion only for such texts. The is_* methods tell whether the whole text
+     * is a valid number of the type (see parse_int64, parse_uint64, parse_double).
+     *
+     * The value does not own the text - it must be NUL-terminated and must outlive the value.
+     */
+    class Value
+    {
+    public:
+        Value() = default;
+        explicit Value(View text);
+
+        void assign(View text);
+
+        int32_t as_int() const { return _integer; }
+        uint32_t as_uint() const { return static_cast<uint32_t>(_integer); }
+        int64_t as_int64() const { return _int64; }
+        uint64_t as_uint64() const { return _uint64; }
+        double as_double() const { return _real; }
+        bool as_bool() const { return _boolean; }
+        View as_string() const { return _text; }
+
+        bool is_int64() const { return _is_int64; }
+        bool is_uint64() const { return _is_uint64; }
+        bool is_double() const { return _is_double; }
+
+    private:
+        friend class Parser; // restores values from snapshots without converting them again
+
+        View _text;
+        int32_t _integer = 0;
+        int64_t _int64 = 0;
+        uint64_t _uint64 = 0;
+        double _real = 0.0;
+        bool _boolean = false;
+        bool _is_int64 = false;
+        bool _is_uint64 = false;
+        bool _is_double = false;
+    };
+} // namespace Options
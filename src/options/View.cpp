@@ -0,0 +1,19 @@
+#include <cstring>
+#include <ostream>
+
+#include "View.hpp"
+
+namespace Options
+{
+    View::View(const char *text) : _data{text}, _size{strlen(text)} {}
+
+    bool View::equals(View other) const
+    {
+        return _size == other._size && (_size == 0 || memcmp(_data, other._data, _size) == 0);
+    }
+
+    std::ostream &operator<<(std::ostream &stream, View view)
+    {
+        return stream.write(view.data(), static_cast<std::streamsize>(view.size()));
+    }
+} // namespace Options
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+namespace Options
+{
+    /* Non-owning view of a piece of text - a pointer and a length.
+     *
+     * Values and positional arguments are returned as views, so they can refer to the original
+     * argv strings without copying them. Making a std::string out of a view is the only place where
+     * the text gets copied, and it happens only when explicitly requested (str() or a conversion).
+     *
+     * All the views returned by the library point to NUL-terminated text, so c_str() can be used for them.
+     * For a view created from a pointer and a length it is the responsibility of the creator.
+     */
+    class View
+    {
+    public:
+        View() = default;
+        View(const char *data, size_t size) : _data{data}, _size{size} {}
+        View(const char *text); // NOLINT - implicit on purpose, so literals can be used as views
+        View(const std::string &text) : _data{text.c_str()}, _size{text.size()} {} // NOLINT - same as above
+
+        const char *data() const { return _data; }
+        const char *c_str() const { return _data; }
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        const char *begin() const { return _data; }
+        const char *end() const { return _data + _size; }
+        char operator[](size_t idx) const { return _data[idx]; }
+
+        std::string str() const { return {_data, _size}; }
+        operator std::string() const { return str(); } // NOLINT - implicit on purpose, as std::string is used widely
+
+        friend bool operator==(View lhs, View rhs) { return lhs.equals(rhs); }
+        friend bool operator!=(View lhs, View rhs) { return !lhs.equals(rhs); }
+
+    private:
+        bool equals(View other) const;
+
+        const char *_data = "";
+        size_t _size = 0;
+    };
+
+    std::ostream &operator<<(std::ostream &stream, View view);
+} // namespace Options
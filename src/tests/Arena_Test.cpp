@@ -0,0 +1,63 @@
+#include <string>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "options/Arena.hpp"
+
+TEST_CASE("Arena")
+{
+    constexpr size_t BLOCK_SIZE = 16;
+    Options::Arena arena(BLOCK_SIZE);
+
+    SECTION("Storing texts")
+    {
+        const auto first = arena.store("first");
+        const auto second = arena.store(std::string("second"));
+        const auto empty = arena.store("");
+
+        REQUIRE(first == "first");
+        REQUIRE(first.c_str()[first.size()] == '\0');
+        REQUIRE(second == "second");
+        REQUIRE(empty.empty());
+        REQUIRE(arena.size() == 6 + 7 + 1);
+
+        // texts are stored one after another in a block
+        REQUIRE(second.data() == first.data() + first.size() + 1);
+    }
+
+    SECTION("Texts stay valid when new blocks are allocated")
+    {
+        const auto small = arena.store("small");
+        const auto big = arena.store("a text which does not fit into a single block");
+        const auto after = arena.store("after");
+
+        REQUIRE(small == "small");
+        REQUIRE(big == "a text which does not fit into a single block");
+        REQUIRE(after == "after");
+    }
+
+    SECTION("Storing a part of a text")
+    {
+        const char *text = "key=value";
+        const auto key = arena.store(Options::View(text, 3));
+
+        REQUIRE(key == "key");
+        REQUIRE(key.c_str()[3] == '\0');
+    }
+
+    SECTION("Rewinding reuses the memory")
+    {
+        const auto kept = arena.store("kept");
+        const auto mark = arena.mark();
+
+        const auto first = arena.store("some text which needs a few blocks of memory");
+        arena.store("more");
+
+        arena.rewind(mark);
+        REQUIRE(arena.size() == 5);
+
+        const auto second = arena.store("some text which needs a few blocks of memory");
+        REQUIRE(second.data() == first.data());
+        REQUIRE(kept == "kept");
+    }
+}
@@ -0,0 +1,100 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "options/Parser.hpp"
+
+namespace
+{
+    void define_build(Options::Parser &parser)
+    {
+        parser.add_optional("jobs", 'j', "Number of jobs", "1");
+        parser.add_flag("release", "Release build");
+    }
+
+    // Returns what the parser prints for "prg --__complete words...".
+    std::string complete(const Options::Parser &parser, const std::vector<const char *> &words)
+    {
+        std::vector<const char *> argv{"prg", "--__complete"};
+        argv.insert(argv.end(), words.begin(), words.end());
+
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+        REQUIRE(parser.complete(static_cast<int>(argv.size()), argv.data(), fds[1]));
+        close(fds[1]);
+
+        std::string result;
+        char buffer[256];
+        for (ssize_t size = 0; (size = read(fds[0], buffer, sizeof(buffer))) > 0;)
+            result.append(buffer, static_cast<size_t>(size));
+        close(fds[0]);
+
+        return result;
+    }
+} // namespace
+
+TEST_CASE("Completion")
+{
+    Options::Parser parser;
+
+    parser.add_optional("threshold", 't', "Some threshold\nwith more lines", "1");
+    parser.add_flag("verbose", 'v', "Verbose");
+    parser.add_flag("version", "Version");
+    parser.add_choice("level", 'l', "Level", {"none", "debug", "error"}, "none");
+    parser.add_subcommand("build", "Build the project", define_build);
+    parser.add_subcommand("bench", "Run benchmarks", nullptr);
+
+    SECTION("Not a query")
+    {
+        const char *argv[] = {"prg", "--verbose"};
+        REQUIRE_FALSE(parser.complete(2, argv));
+        REQUIRE_FALSE(parser.complete(1, argv));
+    }
+
+    SECTION("Long names in sorted order")
+    {
+        REQUIRE(complete(parser, {"--ver"}) == "--verbose\tVerbose\n--version\tVersion\n");
+        REQUIRE(complete(parser, {"--t"}) == "--threshold\tSome threshold\n");
+        REQUIRE(complete(parser, {"--x"}).empty());
+        REQUIRE(complete(parser, {"-"}) ==
+                "--level\tLevel\n--threshold\tSome threshold\n--verbose\tVerbose\n--version\tVersion\n");
+        REQUIRE(complete(parser, {"-v"}).empty());
+
+        parser.set_prefix_matching(true);
+        parser.freeze(); // the prefix index of the parser is used
+        REQUIRE(complete(parser, {"-v", "--ver"}) == "--verbose\tVerbose\n--version\tVersion\n");
+    }
+
+    SECTION("Choices")
+    {
+        REQUIRE(complete(parser, {"--level", "d"}) == "debug\n");
+        REQUIRE(complete(parser, {"-l", ""}) == "none\ndebug\nerror\n");
+        REQUIRE(complete(parser, {"--level=e"}) == "--level=error\n");
+        REQUIRE(complete(parser, {"--threshold", ""}).empty());
+    }
+
+    SECTION("Subcommands")
+    {
+        REQUIRE(complete(parser, {"b"}) == "build\tBuild the project\nbench\tRun benchmarks\n");
+        REQUIRE(complete(parser, {""}) == "build\tBuild the project\nbench\tRun benchmarks\n");
+        REQUIRE(complete(parser, {"-v", "build", "--j"}) == "--jobs\tNumber of jobs\n");
+        REQUIRE(complete(parser, {"-t", "build", "--j"}).empty()); // "build" is the value of -t
+        REQUIRE(complete(parser, {"--", "b"}).empty());
+    }
+
+    SECTION("Scripts")
+    {
+        const std::string bash = Options::completion_script(Options::Shell::Bash, "/usr/bin/my-tool");
+        REQUIRE(bash.find("complete -o default -F _my_tool_complete my-tool") != std::string::npos);
+        REQUIRE(bash.find("--__complete") != std::string::npos);
+
+        const std::string zsh = Options::completion_script(Options::Shell::Zsh, "my-tool");
+        REQUIRE(zsh.find("#compdef my-tool") != std::string::npos);
+        REQUIRE(zsh.find("compdef _my_tool_complete my-tool") != std::string::npos);
+
+        const std::string fish = Options::completion_script(Options::Shell::Fish, "my-tool");
+        REQUIRE(fish.find("complete -c my-tool -a '(__my_tool_complete)'") != std::string::npos);
+    }
+}
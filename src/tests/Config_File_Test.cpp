@@ -0,0 +1,135 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "options/Config_File.hpp"
+#include "options/Converters.hpp"
+#include "options/Parser.hpp"
+
+#include "Temporary_File.hpp"
+
+namespace
+{
+    using Entries = std::vector<std::pair<std::string, std::string>>;
+
+    // Returns the entries read until the end or a malformed line.
+    Entries read_entries(const std::string &contents, bool &malformed)
+    {
+        const Temporary_File file("options_entries.cfg", contents);
+
+        Options::Mapped_File mapped_file;
+        REQUIRE(mapped_file.open(file.path().c_str()));
+
+        Options::Config_File config(mapped_file);
+        Entries result;
+
+        Options::View key;
+        Options::View value;
+        while (config.next(key, value))
+            result.emplace_back(key.str(), value.str());
+
+        malformed = config.malformed();
+        return result;
+    }
+} // namespace
+
+TEST_CASE("Config_File")
+{
+    bool malformed = false;
+
+    SECTION("Reading entries")
+    {
+        REQUIRE(read_entries("", malformed).empty());
+        REQUIRE(read_entries("\n# comment = 1\n; another\n\n", malformed).empty());
+
+        const Entries expected = {{"name", "value"}, {"spaced", "a b"}, {"quoted", " c "}, {"empty", ""},
+                                  {"flag", ""},      {"last", "x=y"}};
+
+        REQUIRE(read_entries("name=value\n  spaced = a b  \r\nquoted=' c '\nempty=\nflag\nlast = x=y", malformed) ==
+                expected);
+        REQUIRE_FALSE(malformed);
+    }
+
+    SECTION("Malformed line")
+    {
+        const Entries expected = {{"first", "1"}};
+        REQUIRE(read_entries("first=1\n = 2\nthird=3", malformed) == expected);
+        REQUIRE(malformed);
+    }
+
+    SECTION("Parsing into options")
+    {
+        Options::Parser parser;
+
+        const auto config = parser.add_optional("config", 'c', "Configuration file", "");
+        const auto name = parser.add_mandatory("name", 'n', "Name");
+        const auto count = parser.add_optional("count", "Count", "1", Options::is_int64);
+        const auto verbose = parser.add_flag("verbose", 'v', "Verbose");
+
+        const Temporary_File file("options_parsing.cfg", "# settings\nname = from config\ncount = 10\nverbose\n");
+
+        SECTION("file only")
+        {
+            REQUIRE(parser.parse_config(file.path()));
+
+            const char *argv[] = {"prg"};
+            REQUIRE(parser.parse(1, argv));
+
+            REQUIRE(parser.as_string(name) == "from config");
+            REQUIRE(parser.as_int64(count) == 10);
+            REQUIRE(parser.as_bool(verbose));
+        }
+
+        SECTION("command line takes precedence regardless of the order")
+        {
+            const char *argv[] = {"prg", "--count", "20", "-n", "from argv"};
+
+            REQUIRE(parser.parse(5, argv));
+            REQUIRE(parser.parse_config(file.path()));
+
+            REQUIRE(parser.as_string(name) == "from argv");
+            REQUIRE(parser.as_int64(count) == 20);
+            REQUIRE(parser.as_bool(verbose));
+
+            parser.freeze();
+
+            Options::Parse_Result result;
+            REQUIRE(parser.parse(5, argv, result)); // parsing into a result starts from scratch
+            REQUIRE(parser.parse_config(file.path(), result));
+
+            REQUIRE(result.as_int64(count) == 20);
+            REQUIRE(result.source(count) == Options::Source::Command_Line);
+            REQUIRE(result.source(verbose) == Options::Source::Config);
+            REQUIRE(result.source(config) == Options::Source::Default);
+        }
+
+        SECTION("file given by an option")
+        {
+            parser.set_config_option(config);
+
+            const char *argv[] = {"prg", "-c", file.path().c_str(), "-n", "from argv"};
+            REQUIRE(parser.parse(5, argv));
+
+            REQUIRE(parser.as_string(name) == "from argv");
+            REQUIRE(parser.as_int64(count) == 10);
+
+            parser.reset();
+
+            const char *without_name[] = {"prg", "-c", file.path().c_str()};
+            REQUIRE(parser.parse(3, without_name)); // the mandatory option comes from the file
+        }
+
+        SECTION("errors")
+        {
+            REQUIRE_FALSE(parser.parse_config("options_does_not_exist.cfg"));
+
+            const Temporary_File unknown("options_unknown.cfg", "unknown = 1\n");
+            REQUIRE_FALSE(parser.parse_config(unknown.path()));
+
+            const Temporary_File invalid("options_invalid.cfg", "count = ten\n");
+            REQUIRE_FALSE(parser.parse_config(invalid.path()));
+        }
+    }
+}
@@ -0,0 +1,175 @@
+#include <clocale>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "options/Converters.hpp"
+
+namespace
+{
+    Options::Conversion int64_of(const char *text, int64_t &result)
+    {
+        return Options::parse_int64(text, strlen(text), result);
+    }
+
+    Options::Conversion uint64_of(const char *text, uint64_t &result)
+    {
+        return Options::parse_uint64(text, strlen(text), result);
+    }
+
+    Options::Conversion double_of(const char *text, double &result)
+    {
+        return Options::parse_double(text, strlen(text), result);
+    }
+} // namespace
+
+TEST_CASE("Converters")
+{
+    using Options::Conversion;
+
+    SECTION("Lenient conversions")
+    {
+        REQUIRE(Options::as_int("12abc") == 12);
+        REQUIRE(Options::as_int("bla") == 0);
+        REQUIRE(Options::as_uint("3.14") == 3);
+        REQUIRE(Options::as_double("2.5x") == 2.5);
+        REQUIRE(Options::as_bool("True"));
+        REQUIRE(Options::as_bool("1"));
+        REQUIRE_FALSE(Options::as_bool("false"));
+    }
+
+    SECTION("Signed integers")
+    {
+        int64_t result = 0;
+
+        REQUIRE(int64_of("0", result) == Conversion::Ok);
+        REQUIRE(result == 0);
+        REQUIRE(int64_of("-42", result) == Conversion::Ok);
+        REQUIRE(result == -42);
+        REQUIRE(int64_of("+42", result) == Conversion::Ok);
+        REQUIRE(result == 42);
+        REQUIRE(int64_of("0x1f", result) == Conversion::Ok);
+        REQUIRE(result == 31);
+        REQUIRE(int64_of("-0X1F", result) == Conversion::Ok);
+        REQUIRE(result == -31);
+        REQUIRE(int64_of("017", result) == Conversion::Ok);
+        REQUIRE(result == 15);
+        REQUIRE(int64_of("9223372036854775807", result) == Conversion::Ok);
+        REQUIRE(result == std::numeric_limits<int64_t>::max());
+        REQUIRE(int64_of("-9223372036854775808", result) == Conversion::Ok);
+        REQUIRE(result == std::numeric_limits<int64_t>::min());
+
+        result = 7;
+        REQUIRE(int64_of("9223372036854775808", result) == Conversion::Out_Of_Range);
+        REQUIRE(int64_of("-9223372036854775809", result) == Conversion::Out_Of_Range);
+        REQUIRE(int64_of("", result) == Conversion::Empty);
+        REQUIRE(int64_of("-", result) == Conversion::Invalid);
+        REQUIRE(int64_of("12abc", result) == Conversion::Invalid);
+        REQUIRE(int64_of("1.5", result) == Conversion::Invalid);
+        REQUIRE(int64_of("0x", result) == Conversion::Invalid);
+        REQUIRE(int64_of("08", result) == Conversion::Invalid);
+        REQUIRE(int64_of(" 1", result) == Conversion::Invalid);
+        REQUIRE(result == 7); // untouched on failures
+    }
+
+    SECTION("Unsigned integers")
+    {
+        uint64_t result = 0;
+
+        REQUIRE(uint64_of("18446744073709551615", result) == Conversion::Ok);
+        REQUIRE(result == std::numeric_limits<uint64_t>::max());
+        REQUIRE(uint64_of("0xffffffffffffffff", result) == Conversion::Ok);
+        REQUIRE(result == std::numeric_limits<uint64_t>::max());
+        REQUIRE(uint64_of("18446744073709551616", result) == Conversion::Out_Of_Range);
+        REQUIRE(uint64_of("-1", result) == Conversion::Invalid);
+    }
+
+    SECTION("Size suffixes")
+    {
+        uint64_t result = 0;
+
+        REQUIRE(uint64_of("4k", result) == Conversion::Ok);
+        REQUIRE(result == 4096);
+        REQUIRE(uint64_of("2G", result) == Conversion::Ok);
+        REQUIRE(result == 2ULL << 30U);
+        REQUIRE(uint64_of("3m", result) == Conversion::Ok);
+        REQUIRE(result == 3ULL << 20U);
+        REQUIRE(uint64_of("0x10K", result) == Conversion::Ok);
+        REQUIRE(result == 16ULL << 10U);
+        REQUIRE(uint64_of("16E", result) == Conversion::Out_Of_Range);
+        REQUIRE(uint64_of("4kk", result) == Conversion::Invalid);
+        REQUIRE(uint64_of("4x", result) == Conversion::Invalid);
+
+        int64_t signed_result = 0;
+        REQUIRE(int64_of("-1k", signed_result) == Conversion::Ok);
+        REQUIRE(signed_result == -1024);
+    }
+
+    SECTION("Floating point numbers")
+    {
+        double result = 0.0;
+
+        REQUIRE(double_of("3.14", result) == Conversion::Ok);
+        REQUIRE(result == 3.14);
+        REQUIRE(double_of("-1.5e3", result) == Conversion::Ok);
+        REQUIRE(result == -1500.0);
+        REQUIRE(double_of(".5", result) == Conversion::Ok);
+        REQUIRE(result == 0.5);
+        REQUIRE(double_of("5.", result) == Conversion::Ok);
+        REQUIRE(result == 5.0);
+        REQUIRE(double_of("0.000001", result) == Conversion::Ok);
+        REQUIRE(result == 0.000001);
+        REQUIRE(double_of("1e-300", result) == Conversion::Ok);
+        REQUIRE(result == 1e-300);
+        REQUIRE(double_of("123456789012345678901234567890", result) == Conversion::Ok);
+        REQUIRE(result == 123456789012345678901234567890.0);
+        REQUIRE(double_of("0.1234567890123456789012345", result) == Conversion::Ok);
+        REQUIRE(result == 0.1234567890123456789012345);
+        REQUIRE(double_of("-inf", result) == Conversion::Ok);
+        REQUIRE(result == -std::numeric_limits<double>::infinity());
+        REQUIRE(double_of("NaN", result) == Conversion::Ok);
+        REQUIRE(std::isnan(result));
+
+        result = 7.0;
+        REQUIRE(double_of("1e400", result) == Conversion::Out_Of_Range);
+        REQUIRE(double_of("", result) == Conversion::Empty);
+        REQUIRE(double_of("12abc", result) == Conversion::Invalid);
+        REQUIRE(double_of(".", result) == Conversion::Invalid);
+        REQUIRE(double_of("1e", result) == Conversion::Invalid);
+        REQUIRE(double_of("1,5", result) == Conversion::Invalid);
+        REQUIRE(double_of("0x10", result) == Conversion::Invalid);
+        REQUIRE(result == 7.0);
+    }
+
+    SECTION("Floating point numbers do not depend on the locale")
+    {
+        // only meaningful if a locale with a decimal comma is installed
+        if (std::setlocale(LC_NUMERIC, "de_DE.UTF-8") != nullptr)
+        {
+            double result = 0.0;
+
+            REQUIRE(double_of("2.5", result) == Conversion::Ok);
+            REQUIRE(result == 2.5);
+            REQUIRE(double_of("1.00000000000000000000001e300", result) == Conversion::Ok);
+            REQUIRE(result == 1e300);
+            REQUIRE(double_of("2,5", result) == Conversion::Invalid);
+
+            std::setlocale(LC_NUMERIC, "C");
+        }
+    }
+
+    SECTION("Strict conversions of strings")
+    {
+        REQUIRE(Options::as_int64("-5k") == -5120);
+        REQUIRE(Options::as_uint64("12abc") == 0);
+
+        REQUIRE(Options::is_int64("-12"));
+        REQUIRE_FALSE(Options::is_int64("12abc"));
+        REQUIRE(Options::is_uint64("12"));
+        REQUIRE_FALSE(Options::is_uint64("-12"));
+        REQUIRE(Options::is_double("1e5"));
+        REQUIRE_FALSE(Options::is_double("1e5.0"));
+    }
+}
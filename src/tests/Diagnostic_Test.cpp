@@ -0,0 +1,208 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include <string>
+
+#include "options/Converters.hpp"
+#include "options/Parser.hpp"
+
+#include "Temporary_File.hpp"
+
+namespace
+{
+    const Options::Diagnostic &parse_failing(Options::Parser &parser, int argc, const char *const *argv)
+    {
+        parser.reset();
+        REQUIRE_FALSE(parser.parse(argc, argv));
+        return parser.diagnostic();
+    }
+
+    void define_build(Options::Parser &parser)
+    {
+        parser.add_optional("jobs", 'j', "Number of jobs", "1", Options::is_int64);
+    }
+} // namespace
+
+TEST_CASE("Diagnostic")
+{
+    Options::Parser parser;
+
+    const auto name = parser.add_mandatory("name", 'n', "Name");
+    const auto count = parser.add_optional("count", 'c', "Count", "7", Options::is_int64);
+    const auto verbose = parser.add_flag("verbose", 'v', "Verbose");
+    parser.add_flag("version", "Version");
+
+    SECTION("Success leaves no diagnostic")
+    {
+        const char *argv[] = {"prg", "-n", "x", "-c", "5"};
+        REQUIRE(parser.parse(5, argv));
+        REQUIRE_FALSE(parser.diagnostic());
+        REQUIRE(parser.diagnostic().error == Options::Error::None);
+    }
+
+    SECTION("A failure does not outlive its parse")
+    {
+        const char *bogus[] = {"prg", "-n", "x", "--bogus"};
+        REQUIRE_FALSE(parser.parse(4, bogus));
+        REQUIRE(parser.diagnostic().error == Options::Error::Unknown_Option);
+
+        const char *missing[] = {"prg", "-n", "x", "--count"};
+        REQUIRE_FALSE(parser.parse(4, missing));
+        REQUIRE(parser.diagnostic().error == Options::Error::Missing_Value);
+        REQUIRE(parser.diagnostic().token == "--count");
+
+        const char *valid[] = {"prg", "-n", "5"};
+        REQUIRE(parser.parse(3, valid));
+        REQUIRE_FALSE(parser.diagnostic());
+
+        REQUIRE_FALSE(parser.parse_config("options_does_not_exist.cfg"));
+        REQUIRE(parser.diagnostic().error == Options::Error::Unreadable_File);
+        REQUIRE(parser.parse(3, valid));
+        REQUIRE_FALSE(parser.diagnostic());
+    }
+
+    SECTION("Command line errors")
+    {
+        {
+            const char *argv[] = {"prg", "-n", "x", "--unknown"};
+            const auto &diagnostic = parse_failing(parser, 4, argv);
+            REQUIRE(diagnostic.error == Options::Error::Unknown_Option);
+            REQUIRE(diagnostic.argv_index == 3);
+            REQUIRE_FALSE(diagnostic.option.is_valid());
+            REQUIRE(diagnostic.token == "--unknown");
+        }
+        {
+            const char *argv[] = {"prg", "-n", "x", "-c", "ten"};
+            const auto &diagnostic = parse_failing(parser, 5, argv);
+            REQUIRE(diagnostic.error == Options::Error::Invalid_Value);
+            REQUIRE(diagnostic.argv_index == 4);
+            REQUIRE(diagnostic.option == count);
+            REQUIRE(diagnostic.token == "-c");
+            REQUIRE(diagnostic.value == "ten");
+        }
+        {
+            const char *argv[] = {"prg", "-vn"};
+            const auto &diagnostic = parse_failing(parser, 2, argv);
+            REQUIRE(diagnostic.error == Options::Error::Missing_Value);
+            REQUIRE(diagnostic.argv_index == 1);
+            REQUIRE(diagnostic.option == name);
+        }
+        {
+            const char *argv[] = {"prg", "-n", "x", "--verbose=yes"};
+            const auto &diagnostic = parse_failing(parser, 4, argv);
+            REQUIRE(diagnostic.error == Options::Error::Unexpected_Value);
+            REQUIRE(diagnostic.option == verbose);
+            REQUIRE(diagnostic.value == "yes");
+        }
+        {
+            const char *argv[] = {"prg", "-n", "x", "stray"};
+            const auto &diagnostic = parse_failing(parser, 4, argv);
+            REQUIRE(diagnostic.error == Options::Error::Unexpected_Argument);
+            REQUIRE(diagnostic.token == "stray");
+        }
+        {
+            const char *argv[] = {"prg", "-v"};
+            const auto &diagnostic = parse_failing(parser, 2, argv);
+            REQUIRE(diagnostic.error == Options::Error::Missing_Mandatory);
+            REQUIRE(diagnostic.argv_index == -1);
+            REQUIRE(diagnostic.option == name);
+            REQUIRE(diagnostic.token == "name");
+        }
+
+        parser.set_prefix_matching(true);
+        {
+            const char *argv[] = {"prg", "-n", "x", "--ver"};
+            const auto &diagnostic = parse_failing(parser, 4, argv);
+            REQUIRE(diagnostic.error == Options::Error::Ambiguous_Option);
+            REQUIRE(diagnostic.token == "--ver");
+        }
+    }
+
+    SECTION("Texts outlive the arguments")
+    {
+        std::string value = "ten";
+        const char *argv[] = {"prg", "-n", "x", "--count", value.c_str()};
+        const auto &diagnostic = parse_failing(parser, 5, argv);
+        value = "changed";
+        REQUIRE(diagnostic.value == "ten");
+        REQUIRE(std::string(Options::describe(diagnostic.error)) == "invalid value");
+    }
+
+    SECTION("Response files")
+    {
+        parser.set_response_files(true);
+
+        const Temporary_File file("options_diagnostic.rsp", "-n x\n-c ten\n");
+        const std::string at_path = "@" + file.path();
+
+        {
+            const char *argv[] = {"prg", "-v", at_path.c_str()};
+            const auto &diagnostic = parse_failing(parser, 3, argv);
+            REQUIRE(diagnostic.error == Options::Error::Invalid_Value);
+            REQUIRE(diagnostic.argv_index == 2); // the "@path" argument
+            REQUIRE(diagnostic.value == "ten");
+        }
+        {
+            const char *argv[] = {"prg", "-n", "@options_does_not_exist.rsp"};
+            const auto &diagnostic = parse_failing(parser, 3, argv);
+            REQUIRE(diagnostic.error == Options::Error::Unreadable_File);
+            REQUIRE(diagnostic.argv_index == 2);
+            REQUIRE(diagnostic.token == "options_does_not_exist.rsp");
+        }
+    }
+
+    SECTION("Configuration files")
+    {
+        const Temporary_File file("options_diagnostic.cfg", "name = x\n\ncount = 3\nsize = 4\n");
+        REQUIRE_FALSE(parser.parse_config(file.path()));
+
+        const auto &diagnostic = parser.diagnostic();
+        REQUIRE(diagnostic.error == Options::Error::Unknown_Option);
+        REQUIRE(diagnostic.line == 4);
+        REQUIRE(diagnostic.token == "size");
+
+        parser.reset();
+        REQUIRE_FALSE(parser.diagnostic());
+    }
+
+    SECTION("Subcommands and separate results")
+    {
+        parser.add_subcommand("build", "Build", define_build);
+        parser.freeze();
+
+        Options::Parse_Result result;
+
+        const char *argv[] = {"prg", "-n", "x", "build", "-j", "many"};
+        REQUIRE_FALSE(parser.parse(6, argv, result));
+        REQUIRE(result.diagnostic().error == Options::Error::Invalid_Value);
+        REQUIRE(result.diagnostic().argv_index == 5);
+        REQUIRE(result.diagnostic().token == "-j");
+
+        result.reset();
+        const char *unknown[] = {"prg", "-n", "x", "test"};
+        REQUIRE_FALSE(parser.parse(4, unknown, result));
+        REQUIRE(result.diagnostic().error == Options::Error::Unknown_Subcommand);
+        REQUIRE(result.diagnostic().token == "test");
+    }
+
+    SECTION("Accessors without exceptions")
+    {
+        const char *argv[] = {"prg", "-n", "x", "-c", "12"};
+        REQUIRE(parser.parse(5, argv));
+
+        int64_t number = 0;
+        REQUIRE(parser.try_get("count", number));
+        REQUIRE(number == 12);
+
+        Options::View text;
+        REQUIRE(parser.try_get("name", text));
+        REQUIRE(text == "x");
+
+        bool flag = true;
+        REQUIRE(parser.try_get("verbose", flag));
+        REQUIRE_FALSE(flag);
+
+        double real = 1.5;
+        REQUIRE_FALSE(parser.try_get("unknown", real));
+        REQUIRE(real == 1.5); // untouched
+    }
+}
@@ -160,4 +160,63 @@ TEST_CASE("Option")
             REQUIRE(option.as_string() == "world");
         }
     }
+
+    SECTION("Using value validator")
+    {
+        Options::Option option("opt", "valid are integers in range 1..5");
+
+        option.set_optional("3");
+        option.set_validator([](const Options::Value &value) { return value.as_int() >= 1 && value.as_int() <= 5; });
+
+        REQUIRE(option.as_int() == 3);
+
+        REQUIRE_FALSE(option.set_value("7"));
+        REQUIRE_FALSE(option.was_set());
+        REQUIRE(option.as_int() == 3);
+
+        REQUIRE(option.set_value("5"));
+        REQUIRE(option.was_set());
+        REQUIRE(option.as_int() == 5);
+        REQUIRE(option.as_string() == "5");
+    }
+
+    SECTION("Choices")
+    {
+        Options::Option option("level", "one of none, debug, error");
+
+        option.set_optional("none").set_choices({"none", "debug", "error", "debug"});
+
+        REQUIRE(option.is_choice());
+        REQUIRE(option.choices().size() == 3); // the repeated one is ignored
+        REQUIRE(option.choices()[2] == "error");
+        REQUIRE(option.as_choice() == 0);
+        REQUIRE(option.find_choice("err") == Options::Option::NO_CHOICE);
+
+        REQUIRE_FALSE(option.set_value("verbose"));
+        REQUIRE(option.set_value("error"));
+        REQUIRE(option.as_choice() == 2);
+
+        Options::Option plain("plain", "no choices");
+        REQUIRE_FALSE(plain.is_choice());
+        REQUIRE(plain.choices().empty());
+        REQUIRE(plain.as_choice() == Options::Option::NO_CHOICE);
+    }
+
+    SECTION("Converted value follows the latest set value")
+    {
+        Options::Option option("opt", "any value");
+
+        option.set_optional("1.5");
+        REQUIRE(option.as_double() == 1.5);
+
+        REQUIRE(option.set_value("-2"));
+        REQUIRE(option.as_int() == -2);
+        REQUIRE(option.as_uint() == static_cast<uint32_t>(-2));
+        REQUIRE(option.as_double() == -2.0);
+        REQUIRE(option.as_bool());
+
+        REQUIRE(option.set_value("TRUE"));
+        REQUIRE(option.as_int() == 0);
+        REQUIRE(option.as_bool());
+    }
 }
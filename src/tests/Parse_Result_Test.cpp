@@ -0,0 +1,140 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "options/Converters.hpp"
+#include "options/Parser.hpp"
+
+TEST_CASE("Parse_Result")
+{
+    Options::Parser parser;
+
+    const auto name = parser.add_mandatory("name", 'n', "Name");
+    const auto count = parser.add_optional("count", 'c', "Count", "7", Options::is_int64);
+    const auto verbose = parser.add_flag("verbose", 'v', "Verbose");
+
+    SECTION("Requires a frozen parser")
+    {
+        Options::Parse_Result result;
+        const char *argv[] = {"prg", "-n", "x"};
+
+        REQUIRE_THROWS(parser.parse(3, argv, result));
+
+        parser.freeze();
+        REQUIRE(parser.parse(3, argv, result));
+    }
+
+    parser.freeze();
+
+    SECTION("Results are independent of the parser and of each other")
+    {
+        Options::Parse_Result first;
+        Options::Parse_Result second;
+
+        const char *argv_first[] = {"prg", "-n", "first", "-c", "10", "-v", "--", "a", "b"};
+        const char *argv_second[] = {"prg", "--name", "second"};
+
+        REQUIRE(parser.parse(sizeof(argv_first) / sizeof(char *), argv_first, first));
+        REQUIRE(parser.parse(sizeof(argv_second) / sizeof(char *), argv_second, second));
+
+        REQUIRE(first.as_string(name) == "first");
+        REQUIRE(first.as_int64("count") == 10);
+        REQUIRE(first.as_bool(verbose));
+        REQUIRE(first.was_set(count));
+        REQUIRE(first.source(count) == Options::Source::Command_Line);
+        REQUIRE(first.positional_count() == 2);
+        REQUIRE(first.positional(1) == "b");
+
+        REQUIRE(second.as_string("name") == "second");
+        REQUIRE(second.as_int64(count) == 7); // default
+        REQUIRE_FALSE(second.was_set("count"));
+        REQUIRE(second.source("count") == Options::Source::Default);
+        REQUIRE_FALSE(second.as_bool(verbose));
+        REQUIRE(second.positional_count() == 0);
+
+        REQUIRE_THROWS(second.as_int("unknown"));
+
+        // the parser itself was not touched
+        REQUIRE(parser.as_string(name).empty());
+        REQUIRE_FALSE(parser.as_bool(verbose));
+    }
+
+    SECTION("Failed parsing and reusing a result")
+    {
+        Options::Parse_Result result;
+
+        const char *invalid[] = {"prg", "-n", "x", "-c", "ten"};
+        REQUIRE_FALSE(parser.parse(sizeof(invalid) / sizeof(char *), invalid, result));
+
+        const char *missing[] = {"prg", "-v"};
+        REQUIRE_FALSE(parser.parse(sizeof(missing) / sizeof(char *), missing, result));
+
+        // every parse starts from scratch
+        const char *valid[] = {"prg", "-n", "y"};
+        REQUIRE(parser.parse(sizeof(valid) / sizeof(char *), valid, result));
+        REQUIRE(result.as_string(name) == "y");
+        REQUIRE_FALSE(result.as_bool(verbose));
+
+        // nothing of the previous parse satisfies the mandatory option
+        const char *without_name[] = {"prg", "-c", "3"};
+        REQUIRE_FALSE(parser.parse(sizeof(without_name) / sizeof(char *), without_name, result));
+        REQUIRE(result.diagnostic().error == Options::Error::Missing_Mandatory);
+    }
+
+    SECTION("Result can be moved")
+    {
+        Options::Parse_Result result;
+
+        const char *argv[] = {"prg", "-n", "moved", "--", "p"};
+        REQUIRE(parser.parse(sizeof(argv) / sizeof(char *), argv, result));
+
+        Options::Parse_Result moved{std::move(result)};
+        REQUIRE(moved.as_string(name) == "moved");
+        REQUIRE(moved.positional(0) == "p");
+
+        result = std::move(moved);
+        REQUIRE(result.as_string(name) == "moved");
+
+        // a moved from result can be reused
+        REQUIRE(parser.parse(sizeof(argv) / sizeof(char *), argv, moved));
+        REQUIRE(moved.as_string(name) == "moved");
+    }
+
+    SECTION("Many threads share one parser")
+    {
+        constexpr int THREAD_COUNT = 4;
+        constexpr int ITERATIONS = 500;
+
+        std::vector<Options::Parse_Result> results(THREAD_COUNT);
+        std::vector<int> failures(THREAD_COUNT, 0);
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < THREAD_COUNT; ++t)
+        {
+            threads.emplace_back([&, t]() {
+                for (int i = 0; i < ITERATIONS; ++i)
+                {
+                    const std::string value = std::to_string(t * ITERATIONS + i);
+                    const char *argv[] = {"prg", "-n", value.c_str(), "-c", value.c_str(), "--", value.c_str()};
+
+                    Options::Parse_Result &result = results[t];
+                    if (!parser.parse(sizeof(argv) / sizeof(char *), argv, result) || result.as_string(name) != value ||
+                        result.as_int64(count) != t * ITERATIONS + i || result.positional(0) != value)
+                        failures[t] += 1;
+                }
+            });
+        }
+
+        for (auto &thread: threads)
+            thread.join();
+
+        for (int t = 0; t < THREAD_COUNT; ++t)
+        {
+            REQUIRE(failures[t] == 0);
+            REQUIRE(results[t].as_int64(count) == t * ITERATIONS + ITERATIONS - 1);
+        }
+    }
+}
@@ -1,7 +1,35 @@
 #include "catch2/catch_test_macros.hpp"
 
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "options/Converters.hpp"
+#include "options/Option.hpp"
 #include "options/Parser.hpp"
 
+namespace
+{
+    int build_calls = 0;
+
+    void define_build(Options::Parser &parser)
+    {
+        build_calls += 1;
+        parser.add_optional("jobs", 'j', "Number of jobs", "1");
+        parser.add_flag("release", "Release build");
+    }
+
+    int clean_calls = 0;
+
+    void define_clean(Options::Parser &parser)
+    {
+        clean_calls += 1;
+        parser.add_flag("all", 'a', "Remove everything");
+    }
+} // namespace
+
 TEST_CASE("Parser")
 {
     Options::Parser parser;
@@ -210,4 +238,896 @@ TEST_CASE("Parser")
             REQUIRE(parser.as_string("height") == "high");
         }
     }
+
+    SECTION("Many options")
+    {
+        constexpr int COUNT = 300;
+
+        for (int i = 0; i < COUNT; ++i)
+            parser.add_optional("option_" + std::to_string(i), "Some option", std::to_string(i));
+
+        parser.add_flag("verbose", 'v', "Verbose");
+
+        const char *argv[] = {"prg", "--option_7", "70", "-v", "--option_299", "2990"};
+        const size_t ARGC = sizeof(argv) / sizeof(char *);
+
+        REQUIRE(parser.parse(ARGC, argv));
+
+        REQUIRE(parser.as_int("option_0") == 0);
+        REQUIRE(parser.as_int("option_7") == 70);
+        REQUIRE(parser.as_int("option_123") == 123);
+        REQUIRE(parser.as_int("option_299") == 2990);
+        REQUIRE(parser.as_bool("verbose"));
+        REQUIRE_THROWS(parser.as_int("option_300"));
+        REQUIRE_THROWS(parser.as_int("option_"));
+    }
+
+    SECTION("Unknown or malformed names")
+    {
+        parser.add_flag("verbose", 'v', "Verbose");
+
+        const char *single_dash_long[] = {"prg", "-verbose"};
+        REQUIRE_FALSE(parser.parse(2, single_dash_long));
+
+        const char *double_dash_short[] = {"prg", "--v"};
+        REQUIRE_FALSE(parser.parse(2, double_dash_short));
+
+        const char *no_dash[] = {"prg", "verbose"};
+        REQUIRE_FALSE(parser.parse(2, no_dash));
+
+        const char *only_dash[] = {"prg", "-"};
+        REQUIRE_FALSE(parser.parse(2, only_dash));
+    }
+
+    SECTION("First definition of a duplicated name wins")
+    {
+        parser.add_optional("name", 'n', "First", "first");
+        parser.add_optional("name", 'n', "Second", "second");
+
+        const char *argv[] = {"prg", "-n", "given"};
+        REQUIRE(parser.parse(3, argv));
+        REQUIRE(parser.as_string("name") == "given");
+    }
+
+    SECTION("Accessing options via handles")
+    {
+        const auto verbose = parser.add_flag("verbose", 'v', "Verbose");
+        const auto count = parser.add_optional("count", 'c', "Count", "10");
+        const auto ratio = parser.add_optional("ratio", "Ratio", "0.5");
+        const auto name = parser.add_mandatory("name", "Name");
+
+        REQUIRE(verbose.is_valid());
+        REQUIRE_FALSE(Options::Handle().is_valid());
+        REQUIRE(parser.find("count") == count);
+        REQUIRE(parser.find("name") == name);
+        REQUIRE_FALSE(parser.find("non_existing").is_valid());
+
+        const char *argv[] = {"prg", "-v", "--name", "bob", "-c", "42"};
+        REQUIRE(parser.parse(sizeof(argv) / sizeof(char *), argv));
+
+        REQUIRE(parser.as_bool(verbose));
+        REQUIRE(parser.as_int(count) == 42);
+        REQUIRE(parser.as_uint(count) == 42);
+        REQUIRE(parser.as_double(ratio) == 0.5);
+        REQUIRE(parser.as_string(name) == "bob");
+    }
+
+    SECTION("Rejecting invalid numbers while parsing")
+    {
+        const auto size = parser.add_optional("size", "Size in bytes", "1k", Options::is_uint64);
+        const auto offset = parser.add_optional("offset", "Offset", "0", Options::is_int64);
+
+        SECTION("valid numbers")
+        {
+            const char *argv[] = {"prg", "--size", "2G", "--offset", "-0x10"};
+            REQUIRE(parser.parse(sizeof(argv) / sizeof(char *), argv));
+
+            REQUIRE(parser.as_uint64(size) == 2ULL << 30U);
+            REQUIRE(parser.as_int64("offset") == -16);
+            REQUIRE(parser.as_int64(offset) == -16);
+        }
+
+        SECTION("defaults")
+        {
+            const char *argv[] = {"prg"};
+            REQUIRE(parser.parse(1, argv));
+
+            REQUIRE(parser.as_uint64("size") == 1024);
+            REQUIRE(parser.as_int64(offset) == 0);
+        }
+
+        SECTION("invalid number")
+        {
+            const char *argv[] = {"prg", "--size", "12abc"};
+            REQUIRE_FALSE(parser.parse(sizeof(argv) / sizeof(char *), argv));
+        }
+    }
+
+    SECTION("Zero-copy parsing")
+    {
+        const auto name = parser.add_optional("name", 'n', "Name", "nobody");
+        const auto verbose = parser.add_flag("verbose", 'v', "Verbose");
+
+        const char *argv[] = {"prg", "-n", "bob", "-v", "--", "first", "second"};
+        const size_t ARGC = sizeof(argv) / sizeof(char *);
+
+        SECTION("values refer to argv")
+        {
+            parser.set_zero_copy(true);
+            REQUIRE(parser.parse(ARGC, argv));
+
+            REQUIRE(parser.as_view(name).data() == argv[2]);
+            REQUIRE(parser.as_bool(verbose));
+            REQUIRE(parser.positional_view(0).data() == argv[5]);
+            REQUIRE(parser.positional_view(1).data() == argv[6]);
+        }
+
+        SECTION("values are copied by default")
+        {
+            REQUIRE(parser.parse(ARGC, argv));
+
+            REQUIRE(parser.as_view(name) == "bob");
+            REQUIRE(parser.as_view(name).data() != argv[2]);
+            REQUIRE(parser.positional_view(0).data() != argv[5]);
+        }
+
+        SECTION("positionals as a range")
+        {
+            parser.set_zero_copy(true);
+            REQUIRE(parser.parse(ARGC, argv));
+
+            const auto positionals = parser.positionals();
+            REQUIRE(positionals.size() == 2);
+
+            std::string joined;
+            for (const auto &positional: positionals)
+                joined += positional.str() + ";";
+
+            REQUIRE(joined == "first;second;");
+        }
+    }
+
+    SECTION("Reusing a parser")
+    {
+        const auto name = parser.add_mandatory("name", 'n', "Name");
+        const auto verbose = parser.add_flag("verbose", 'v', "Verbose");
+        parser.freeze();
+
+        REQUIRE(parser.is_frozen());
+        REQUIRE_THROWS(parser.add_flag("late", "Added too late"));
+
+        const char *first[] = {"prg", "-n", "first", "-v", "--", "positional"};
+        REQUIRE(parser.parse(sizeof(first) / sizeof(char *), first));
+        REQUIRE(parser.as_string(name) == "first");
+        REQUIRE(parser.positional_count() == 1);
+
+        SECTION("reset forgets the values")
+        {
+            parser.reset();
+
+            REQUIRE(parser.positional_count() == 0);
+            REQUIRE_FALSE(parser.as_bool(verbose));
+            REQUIRE(parser.as_string(name).empty());
+
+            const char *missing[] = {"prg", "-v"};
+            REQUIRE_FALSE(parser.parse(2, missing)); // name was forgotten, so it is missing now
+
+            parser.reset();
+
+            const char *second[] = {"prg", "--name", "second"};
+            REQUIRE(parser.parse(3, second));
+            REQUIRE(parser.as_string(name) == "second");
+            REQUIRE_FALSE(parser.as_bool(verbose));
+        }
+
+        SECTION("many command lines")
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                parser.reset();
+
+                const std::string value = "value_" + std::to_string(i);
+                const char *argv[] = {"prg", "-n", value.c_str(), "--", value.c_str()};
+                REQUIRE(parser.parse(sizeof(argv) / sizeof(char *), argv));
+                REQUIRE(parser.as_string(name) == value);
+                REQUIRE(parser.positional(0) == value);
+            }
+        }
+
+        SECTION("cloned schema is independent")
+        {
+            const auto clone = parser.clone_schema();
+
+            REQUIRE(clone->is_frozen());
+            REQUIRE(clone->find("name") == name);
+            REQUIRE(clone->as_string(name).empty());
+            REQUIRE(clone->positional_count() == 0);
+
+            const char *other[] = {"prg", "-n", "other"};
+            REQUIRE(clone->parse(3, other));
+            REQUIRE(clone->as_string("name") == "other");
+            REQUIRE(parser.as_string("name") == "first");
+        }
+    }
+
+    SECTION("Environment variables")
+    {
+        const auto name = parser.add_mandatory("name", 'n', "Name");
+        const auto count = parser.add_optional("count", "Count", "1", Options::is_int64);
+        const auto verbose = parser.add_flag("verbose", 'v', "Verbose");
+        const auto other = parser.add_optional("other", "Not set", "default");
+
+        parser.bind_env(name, "OPTIONS_TEST_NAME");
+        parser.bind_env(count, "OPTIONS_TEST_COUNT");
+        parser.bind_env(verbose, "OPTIONS_TEST_VERBOSE");
+        parser.bind_env(other, "OPTIONS_TEST_NOT_SET");
+
+        setenv("OPTIONS_TEST_NAME", "from env", 1);
+        setenv("OPTIONS_TEST_COUNT", "5", 1);
+        setenv("OPTIONS_TEST_VERBOSE", "", 1);
+        unsetenv("OPTIONS_TEST_NOT_SET");
+
+        REQUIRE(parser.get_possible_options().find("(env: OPTIONS_TEST_COUNT)") != std::string::npos);
+
+        SECTION("mandatory option from the environment")
+        {
+            const char *argv[] = {"prg"};
+            REQUIRE(parser.parse(1, argv));
+
+            REQUIRE(parser.as_string(name) == "from env");
+            REQUIRE(parser.as_int64(count) == 5);
+            REQUIRE(parser.as_bool(verbose));
+            REQUIRE(parser.as_string(other) == "default");
+        }
+
+        SECTION("sources of the values of the parser")
+        {
+            const char *argv[] = {"prg", "--count", "7"};
+            REQUIRE(parser.parse(3, argv));
+
+            REQUIRE(parser.source(count) == Options::Source::Command_Line);
+            REQUIRE(parser.source("name") == Options::Source::Environment);
+            REQUIRE(parser.source(other) == Options::Source::Default);
+            REQUIRE(parser.was_set(verbose));
+            REQUIRE(parser.was_set("count"));
+            REQUIRE_FALSE(parser.was_set(other));
+            REQUIRE_THROWS(parser.source("unknown"));
+        }
+
+        SECTION("command line takes precedence")
+        {
+            parser.freeze();
+
+            Options::Parse_Result result;
+            const char *argv[] = {"prg", "--count", "7"};
+            REQUIRE(parser.parse(3, argv, result));
+
+            REQUIRE(result.as_int64(count) == 7);
+            REQUIRE(result.source(count) == Options::Source::Command_Line);
+            REQUIRE(result.source(name) == Options::Source::Environment);
+            REQUIRE(result.source(other) == Options::Source::Default);
+        }
+
+        SECTION("invalid value")
+        {
+            setenv("OPTIONS_TEST_COUNT", "five", 1);
+
+            const char *argv[] = {"prg"};
+            REQUIRE_FALSE(parser.parse(1, argv));
+        }
+
+        unsetenv("OPTIONS_TEST_NAME");
+        unsetenv("OPTIONS_TEST_COUNT");
+        unsetenv("OPTIONS_TEST_VERBOSE");
+    }
+
+    SECTION("Subcommands")
+    {
+        const auto verbose = parser.add_flag("verbose", 'v', "Verbose");
+        parser.add_subcommand("build", "Build the project", define_build);
+        parser.add_subcommand("clean", "Remove the build files", define_clean);
+
+        build_calls = 0;
+        clean_calls = 0;
+
+        REQUIRE(parser.get_possible_options().find("Remove the build files") != std::string::npos);
+        REQUIRE(clean_calls == 0);
+
+        SECTION("only the selected subcommand is built")
+        {
+            const char *argv[] = {"prg", "-v", "build", "-j", "8", "--", "target"};
+            REQUIRE(parser.parse(sizeof(argv) / sizeof(char *), argv));
+
+            REQUIRE(build_calls == 1);
+            REQUIRE(clean_calls == 0);
+
+            REQUIRE(parser.as_bool(verbose));
+            REQUIRE(parser.subcommand_name() == "build");
+            REQUIRE(parser.positional_count() == 0);
+
+            Options::Parser &build = parser.subcommand("build");
+            REQUIRE(build.as_int("jobs") == 8);
+            REQUIRE_FALSE(build.as_bool("release"));
+            REQUIRE(build.positional(0) == "target");
+
+            parser.reset();
+            REQUIRE(parser.subcommand_name().empty());
+            REQUIRE(build.as_int("jobs") == 1);
+
+            const char *again[] = {"prg", "build", "--release"};
+            REQUIRE(parser.parse(3, again));
+            REQUIRE(build_calls == 1);
+            REQUIRE(build.as_bool("release"));
+
+            const char *without[] = {"prg", "-v"};
+            REQUIRE(parser.parse(2, without));
+            REQUIRE(parser.subcommand_name().empty());
+        }
+
+        SECTION("help of a subcommand on demand")
+        {
+            REQUIRE(parser.subcommand("clean").get_possible_options().find("--all") != std::string::npos);
+            REQUIRE(clean_calls == 1);
+            REQUIRE_THROWS(parser.subcommand("unknown"));
+        }
+
+        SECTION("options of a subcommand belong to it")
+        {
+            const char *parent_option_later[] = {"prg", "clean", "-v"};
+            REQUIRE_FALSE(parser.parse(3, parent_option_later));
+
+            parser.reset();
+
+            const char *unknown[] = {"prg", "deploy"};
+            REQUIRE_FALSE(parser.parse(2, unknown));
+        }
+
+        SECTION("into a separate result")
+        {
+            parser.freeze();
+
+            Options::Parse_Result result;
+            REQUIRE_THROWS(result.subcommand_result());
+
+            const char *argv[] = {"prg", "clean", "--all"};
+            REQUIRE(parser.parse(3, argv, result));
+
+            REQUIRE(result.subcommand() == "clean");
+            REQUIRE(result.subcommand_result().as_bool("all"));
+            REQUIRE_FALSE(parser.subcommand("clean").as_bool("all"));
+        }
+    }
+
+    SECTION("Unique prefixes of long names")
+    {
+        const auto threshold = parser.add_optional("threshold", 't', "Threshold", "1");
+        const auto threads = parser.add_optional("threads", "Threads", "1");
+        const auto bar = parser.add_flag("bar", "Bar");
+        const auto barrel = parser.add_flag("barrel", "Barrel");
+
+        SECTION("disabled by default")
+        {
+            const char *argv[] = {"prg", "--thres", "5"};
+            REQUIRE_FALSE(parser.parse(3, argv));
+        }
+
+        parser.set_prefix_matching(true);
+
+        SECTION("unique prefix")
+        {
+            const char *argv[] = {"prg", "--thres", "5", "--threa", "6", "--barr"};
+            REQUIRE(parser.parse(sizeof(argv) / sizeof(char *), argv));
+
+            REQUIRE(parser.as_int(threshold) == 5);
+            REQUIRE(parser.as_int(threads) == 6);
+            REQUIRE(parser.as_bool(barrel));
+            REQUIRE_FALSE(parser.as_bool(bar));
+        }
+
+        SECTION("exact name wins")
+        {
+            const char *argv[] = {"prg", "--bar"};
+            REQUIRE(parser.parse(2, argv));
+            REQUIRE(parser.as_bool(bar));
+            REQUIRE_FALSE(parser.as_bool(barrel));
+        }
+
+        SECTION("ambiguous or unknown prefix")
+        {
+            const char *ambiguous[] = {"prg", "--thr", "5"};
+            REQUIRE_FALSE(parser.parse(3, ambiguous));
+
+            const char *unknown[] = {"prg", "--x"};
+            REQUIRE_FALSE(parser.parse(2, unknown));
+
+            const char *too_long[] = {"prg", "--barrels"};
+            REQUIRE_FALSE(parser.parse(2, too_long));
+        }
+
+        SECTION("options added later are found too")
+        {
+            const char *first[] = {"prg", "--thres", "5"};
+            REQUIRE(parser.parse(3, first));
+
+            parser.add_optional("zeta", "Zeta", "0");
+            parser.freeze();
+
+            Options::Parse_Result result;
+            const char *second[] = {"prg", "--ze", "3"};
+            REQUIRE(parser.parse(3, second, result));
+            REQUIRE(result.as_int("zeta") == 3);
+        }
+    }
+
+    SECTION("Attached values and bundled short names")
+    {
+        const auto all = parser.add_flag("all", 'a', "All");
+        const auto brief = parser.add_flag("brief", 'b', "Brief");
+        const auto color = parser.add_flag("color", 'c', "Color");
+        const auto output = parser.add_optional("output", 'o', "Output", "-");
+        const auto number = parser.add_optional("number", 'n', "Number", "0");
+
+        SECTION("bundled flags")
+        {
+            const char *argv[] = {"prg", "-abc"};
+            REQUIRE(parser.parse(2, argv));
+            REQUIRE(parser.as_bool(all));
+            REQUIRE(parser.as_bool(brief));
+            REQUIRE(parser.as_bool(color));
+        }
+
+        SECTION("value attached to a short name")
+        {
+            const char *argv[] = {"prg", "-ofile", "-n5", "-ab", "-n", "-6"};
+            REQUIRE(parser.parse(sizeof(argv) / sizeof(char *), argv));
+            REQUIRE(parser.as_string(output) == "file");
+            REQUIRE(parser.as_int(number) == -6);
+            REQUIRE(parser.as_bool(brief));
+        }
+
+        SECTION("value ends the bundle")
+        {
+            const char *argv[] = {"prg", "-aofile", "-cn", "7"};
+            REQUIRE(parser.parse(sizeof(argv) / sizeof(char *), argv));
+            REQUIRE(parser.as_bool(all));
+            REQUIRE(parser.as_string(output) == "file");
+            REQUIRE(parser.as_bool(color));
+            REQUIRE(parser.as_int(number) == 7);
+        }
+
+        SECTION("value after = in a long name")
+        {
+            parser.set_zero_copy(true);
+
+            const char *argv[] = {"prg", "--output=a=b", "--number=", "--all"};
+            REQUIRE(parser.parse(sizeof(argv) / sizeof(char *), argv));
+            REQUIRE(parser.as_string(output) == "a=b");
+            REQUIRE(parser.as_view(output).data() == argv[1] + 9); // no copy
+            REQUIRE(parser.as_string(number).empty());
+            REQUIRE(parser.as_bool(all));
+        }
+
+        SECTION("malformed")
+        {
+            const char *flag_with_value[] = {"prg", "--all=yes"};
+            REQUIRE_FALSE(parser.parse(2, flag_with_value));
+
+            const char *unknown_in_bundle[] = {"prg", "-abx"};
+            REQUIRE_FALSE(parser.parse(2, unknown_in_bundle));
+
+            const char *missing_value[] = {"prg", "-ao"};
+            REQUIRE_FALSE(parser.parse(2, missing_value));
+        }
+    }
+
+    SECTION("Multi-valued options")
+    {
+        const auto input = parser.add_multiple("input", 'i', "Input files", Options::Option::SEPARATOR_NOT_USED);
+        const auto weight = parser.add_multiple("weight", 'w', "Weights", ',', [](const Options::Value &value) {
+            return value.as_double() >= 0.0;
+        });
+        const auto single = parser.add_optional("single", "Single value", "0");
+
+        SECTION("not given")
+        {
+            const char *argv[] = {"prg"};
+            REQUIRE(parser.parse(1, argv));
+            REQUIRE(parser.as_strings(input).empty());
+            REQUIRE(parser.as_doubles("weight").empty());
+            REQUIRE(parser.as_int64s(single).empty());
+        }
+
+        SECTION("repeated and lists")
+        {
+            const char *argv[] = {"prg", "-i", "a,b", "--input=c", "-w", "1,2.5", "--weight", "3", "-w4"};
+            REQUIRE(parser.parse(sizeof(argv) / sizeof(char *), argv));
+
+            const auto inputs = parser.as_strings(input);
+            REQUIRE(inputs.size() == 2);
+            REQUIRE(inputs[0] == "a,b");
+            REQUIRE(inputs[1] == "c");
+
+            const auto weights = parser.as_doubles(weight);
+            REQUIRE(weights.size() == 4);
+            REQUIRE(weights[0] == 1.0);
+            REQUIRE(weights[1] == 2.5);
+            REQUIRE(weights[3] == 4.0);
+
+            REQUIRE(parser.as_int64s("weight")[2] == 3);
+            REQUIRE(parser.as_strings(weight)[1] == "2.5");
+            REQUIRE(parser.as_double(weight) == 4.0); // the last one
+
+            parser.reset();
+            REQUIRE(parser.as_strings(input).empty());
+        }
+
+        SECTION("every value is validated")
+        {
+            const char *argv[] = {"prg", "-w", "5", "-w", "1,2,-3"};
+            REQUIRE_FALSE(parser.parse(5, argv));
+
+            // nothing of the rejected list is kept
+            REQUIRE(parser.as_doubles(weight).size() == 1);
+            REQUIRE(parser.as_doubles(weight)[0] == 5.0);
+            REQUIRE(parser.as_double(weight) == 5.0);
+        }
+
+        SECTION("higher precedence replaces the values")
+        {
+            setenv("OPTIONS_TEST_WEIGHT", "7,8", 1);
+            parser.bind_env(weight, "OPTIONS_TEST_WEIGHT");
+
+            const char *from_env[] = {"prg"};
+            REQUIRE(parser.parse(1, from_env));
+            REQUIRE(parser.as_doubles(weight).size() == 2);
+
+            parser.reset();
+
+            const char *from_argv[] = {"prg", "-w", "1"};
+            REQUIRE(parser.parse(3, from_argv));
+            REQUIRE(parser.as_doubles(weight).size() == 1);
+            REQUIRE(parser.as_doubles(weight)[0] == 1.0);
+
+            unsetenv("OPTIONS_TEST_WEIGHT");
+        }
+
+        SECTION("reused result")
+        {
+            parser.freeze();
+
+            Options::Parse_Result result;
+            const char *first[] = {"prg", "-i", "a"};
+            REQUIRE(parser.parse(3, first, result));
+
+            const char *second[] = {"prg", "-i", "b"};
+            REQUIRE(parser.parse(3, second, result));
+            REQUIRE(result.as_strings(input).size() == 1);
+            REQUIRE(result.as_strings(input)[0] == "b");
+        }
+    }
+
+    SECTION("Choices")
+    {
+        enum Level
+        {
+            None,
+            Debug,
+            Error
+        };
+
+        const int32_t NO_CHOICE = Options::Option::NO_CHOICE;
+
+        const auto level = parser.add_choice("level", 'l', "Level", {"none", "debug", "error"}, "none");
+        const auto mode = parser.add_choice("mode", "Mode", {"fast", "slow"}, "");
+
+        SECTION("default")
+        {
+            const char *argv[] = {"prg"};
+            REQUIRE(parser.parse(1, argv));
+            REQUIRE(parser.as_choice(level) == None);
+            REQUIRE(parser.as_choice("mode") == NO_CHOICE);
+        }
+
+        SECTION("resolved while parsing")
+        {
+            const char *argv[] = {"prg", "-l", "error", "--mode=slow"};
+            REQUIRE(parser.parse(4, argv));
+            REQUIRE(parser.as_choice(level) == Error);
+            REQUIRE(parser.as_string(level) == "error");
+            REQUIRE(parser.as_choice(mode) == 1);
+
+            parser.reset();
+            REQUIRE(parser.as_choice(level) == None);
+        }
+
+        SECTION("invalid choice")
+        {
+            const char *argv[] = {"prg", "--level", "verbose"};
+            REQUIRE_FALSE(parser.parse(3, argv));
+            REQUIRE(parser.diagnostic().error == Options::Error::Invalid_Value);
+            REQUIRE(parser.diagnostic().option == level);
+            REQUIRE(parser.choices(parser.diagnostic().option).size() == 3);
+            REQUIRE(parser.choices(level)[1] == "debug");
+        }
+
+        SECTION("listed in the help")
+        {
+            REQUIRE(parser.get_possible_options().find("(one of: none debug error)") != std::string::npos);
+        }
+
+        SECTION("in a clone")
+        {
+            parser.freeze();
+            const auto clone = parser.clone_schema();
+
+            const char *argv[] = {"prg", "-l", "debug"};
+            REQUIRE(clone->parse(3, argv));
+            REQUIRE(clone->as_choice(level) == Debug);
+            REQUIRE(clone->choices(mode)[0] == "fast");
+        }
+    }
+
+    SECTION("Help")
+    {
+        parser.add_optional("threshold", 't', "Some threshold which is described by a rather long text", "3.14");
+        parser.add_flag("verbose", 'v', "Verbose");
+
+        const std::string help = parser.help();
+        REQUIRE(help == parser.get_possible_options());
+        REQUIRE(help == " -t, --threshold    Some threshold which is described by a rather long text (default: 3.14)\n"
+                        " -v, --verbose      Verbose\n");
+
+        SECTION("wrapped")
+        {
+            REQUIRE(parser.help(50) == " -t, --threshold    Some threshold which is\n"
+                                       "                    described by a rather long\n"
+                                       "                    text (default: 3.14)\n"
+                                       " -v, --verbose      Verbose\n");
+
+            REQUIRE(parser.help(30) == help); // too narrow to wrap
+            REQUIRE(parser.help() == help);
+        }
+
+        SECTION("into a buffer")
+        {
+            char buffer[16];
+            REQUIRE(parser.write_help(buffer, sizeof(buffer)) == help.size());
+            REQUIRE(std::string(buffer) == help.substr(0, sizeof(buffer) - 1));
+
+            std::string large(help.size() + 1, 'x');
+            REQUIRE(parser.write_help(&large[0], large.size()) == help.size());
+            REQUIRE(large.c_str() == help);
+        }
+
+        SECTION("into a file descriptor")
+        {
+            int fds[2];
+            REQUIRE(pipe(fds) == 0);
+            REQUIRE(parser.print_help(fds[1]));
+            close(fds[1]);
+
+            std::string written(help.size() + 1, '\0');
+            REQUIRE(read(fds[0], &written[0], written.size()) == static_cast<ssize_t>(help.size()));
+            close(fds[0]);
+            REQUIRE(written.c_str() == help);
+        }
+
+        SECTION("updated when the options change")
+        {
+            parser.add_flag("quiet", 'q', "Quiet");
+            REQUIRE(parser.help().find("--quiet") != std::string::npos);
+
+            const auto count = parser.add_optional("count", "Count", "1");
+            parser.bind_env(count, "OPTIONS_TEST_HELP_COUNT");
+            REQUIRE(parser.help().find("(env: OPTIONS_TEST_HELP_COUNT)") != std::string::npos);
+        }
+    }
+
+    SECTION("Applying options at runtime")
+    {
+        const auto name = parser.add_mandatory("name", 'n', "Name");
+        const auto count = parser.add_optional("count", 'c', "Count", "0", Options::is_int64);
+        const auto level = parser.add_choice("level", "Level", {"low", "high"}, "low");
+        const auto verbose = parser.add_flag("verbose", 'v', "Verbose");
+        const auto weight = parser.add_multiple("weight", 'w', "Weights", ',');
+
+        const char *argv[] = {"prg", "-n", "server", "-w", "1,2", "--", "input"};
+        REQUIRE(parser.parse(sizeof(argv) / sizeof(char *), argv));
+
+        std::vector<Options::Handle> changed;
+
+        SECTION("only the given options change")
+        {
+            std::string value = "7"; // the texts are copied
+            const char *tokens[] = {"--count", value.c_str(), "--level=high", "-n", "server"};
+            REQUIRE(parser.apply(sizeof(tokens) / sizeof(char *), tokens, &changed));
+            value = "x";
+
+            REQUIRE(changed.size() == 2); // the name is the same
+            REQUIRE(changed[0] == count);
+            REQUIRE(changed[1] == level);
+
+            REQUIRE(parser.as_int(count) == 7);
+            REQUIRE(parser.as_choice(level) == 1);
+            REQUIRE(parser.as_string(name) == "server");
+            REQUIRE(parser.as_doubles(weight).size() == 2);
+            REQUIRE(parser.positional(0) == "input");
+        }
+
+        SECTION("values of a multi-valued option are replaced")
+        {
+            const char *tokens[] = {"-w", "3", "-vw", "4"};
+            REQUIRE(parser.apply(4, tokens, &changed));
+
+            REQUIRE(changed.size() == 2);
+            REQUIRE(changed[0] == weight);
+            REQUIRE(changed[1] == verbose);
+
+            REQUIRE(parser.as_strings(weight).size() == 2);
+            REQUIRE(parser.as_strings(weight)[0] == "3");
+            REQUIRE(parser.as_strings(weight)[1] == "4");
+            REQUIRE(parser.as_bool(verbose));
+        }
+
+        SECTION("nothing changes when an option is invalid")
+        {
+            const char *tokens[] = {"-c", "5", "-w", "9", "--level", "medium"};
+            REQUIRE_FALSE(parser.apply(6, tokens, &changed));
+
+            REQUIRE(changed.empty());
+            REQUIRE(parser.diagnostic().error == Options::Error::Invalid_Value);
+            REQUIRE(parser.diagnostic().argv_index == 5);
+            REQUIRE(parser.diagnostic().value == "medium");
+
+            REQUIRE(parser.as_int(count) == 0);
+            REQUIRE_FALSE(parser.as_bool(verbose));
+            REQUIRE(parser.as_strings(weight).size() == 2);
+            REQUIRE(parser.as_strings(weight)[1] == "2");
+
+            const char *positional[] = {"-v", "input"};
+            REQUIRE_FALSE(parser.apply(2, positional));
+            REQUIRE(parser.diagnostic().error == Options::Error::Unexpected_Argument);
+            REQUIRE_FALSE(parser.as_bool(verbose));
+
+            const char *missing[] = {"-c"};
+            REQUIRE_FALSE(parser.apply(1, missing));
+            REQUIRE(parser.diagnostic().error == Options::Error::Missing_Value);
+
+            const char *valid[] = {"-c", "3"};
+            REQUIRE(parser.apply(2, valid));
+            REQUIRE(parser.diagnostic().error == Options::Error::None);
+            REQUIRE(parser.as_int(count) == 3);
+        }
+
+        SECTION("applying again reuses the memory of the replaced values")
+        {
+            const char *first[] = {"--count", "1", "-w", "5,6"};
+            REQUIRE(parser.apply(4, first));
+            const char *count_text = parser.as_view(count).data();
+            const char *weight_text = parser.as_strings(weight)[0].data();
+
+            for (int i = 0; i < 3; ++i)
+            {
+                const char *again[] = {"--count", (i % 2 == 0) ? "3" : "2", "-w", "7,8"};
+                REQUIRE(parser.apply(4, again));
+                REQUIRE(parser.as_view(count).data() == count_text);
+                REQUIRE(parser.as_strings(weight)[0].data() == weight_text);
+            }
+
+            REQUIRE(parser.as_string(count) == "3");
+            REQUIRE(parser.as_strings(weight)[1] == "8");
+            REQUIRE(parser.as_string(name) == "server");
+        }
+
+        SECTION("into a separate result")
+        {
+            parser.freeze();
+
+            Options::Parse_Result result;
+            REQUIRE(parser.parse(sizeof(argv) / sizeof(char *), argv, result));
+
+            const char *tokens[] = {"--count", "2"};
+            REQUIRE(parser.apply(2, tokens, result, &changed));
+            REQUIRE(changed.size() == 1);
+            REQUIRE(result.as_int(count) == 2);
+            REQUIRE(parser.as_int(count) == 0);
+        }
+    }
+
+    SECTION("Versions of values")
+    {
+        const auto count = parser.add_optional("count", 'c', "Count", "0");
+        const auto verbose = parser.add_flag("verbose", 'v', "Verbose");
+        const auto weight = parser.add_multiple("weight", 'w', "Weights", ',', Options::double_range(0.0, 10.0));
+
+        REQUIRE(parser.generation() == 0);
+
+        const char *argv[] = {"prg", "-c", "0", "-v"};
+        REQUIRE(parser.parse(4, argv));
+
+        REQUIRE(parser.version(count) == 0); // the same as the default
+        REQUIRE(parser.version("verbose") == 1);
+        REQUIRE(parser.version(weight) == 0);
+        REQUIRE(parser.generation() == 1);
+
+        std::vector<Options::Handle> changed;
+
+        const char *same[] = {"-v", "-c", "0"};
+        REQUIRE(parser.apply(3, same, &changed));
+        REQUIRE(changed.empty());
+        REQUIRE(parser.generation() == 1);
+
+        const char *failing[] = {"-c", "2", "-x"};
+        REQUIRE_FALSE(parser.apply(3, failing));
+        REQUIRE(parser.generation() == 1);
+
+        const char *different[] = {"-c", "1", "-c", "2", "-w", "1,2"};
+        REQUIRE(parser.apply(6, different));
+        REQUIRE(parser.version(count) == 1);
+        REQUIRE(parser.version(weight) == 1);
+        REQUIRE(parser.generation() == 3);
+
+        // never going back, so nothing built for an older version is taken as current
+        parser.reset();
+        REQUIRE(parser.version(count) == 2);
+        REQUIRE(parser.version(verbose) == 2);
+        REQUIRE(parser.version(weight) == 2);
+        REQUIRE(parser.generation() == 6);
+
+        const std::string snapshot = parser.save_snapshot();
+        REQUIRE(parser.load_snapshot(snapshot.data(), snapshot.size()));
+        REQUIRE(parser.generation() == 6);
+
+        // resetting a value equal to the default is not a change
+        const char *defaults[] = {"prg", "-c", "0"};
+        REQUIRE(parser.parse(3, defaults));
+        parser.reset();
+        REQUIRE(parser.generation() == 6);
+
+        // neither is a rejected value of a multi-valued option
+        const char *rejected[] = {"prg", "-w", "x"};
+        REQUIRE_FALSE(parser.parse(3, rejected));
+        REQUIRE(parser.version(weight) == 2);
+        REQUIRE(parser.generation() == 6);
+    }
+
+    SECTION("Versions of values in a separate result")
+    {
+        const auto count = parser.add_optional("count", 'c', "Count", "0");
+        const auto verbose = parser.add_flag("verbose", 'v', "Verbose");
+        const auto weight = parser.add_multiple("weight", 'w', "Weights", ',');
+        parser.add_subcommand("build", "Build the project", define_build);
+        parser.freeze();
+
+        Options::Parse_Result result;
+        const char *argv[] = {"prg", "-c", "3", "-v", "-w", "1,2", "-w", "3", "build", "-j", "8"};
+        const int argc = sizeof(argv) / sizeof(char *);
+
+        REQUIRE(parser.parse(argc, argv, result));
+        const uint64_t generation = result.generation();
+        const uint64_t jobs = result.subcommand_result().version("jobs");
+        REQUIRE(result.version(count) == 1);
+        REQUIRE(result.version(weight) == 1);
+        REQUIRE(jobs == 1);
+
+        // the same command line again changes nothing
+        REQUIRE(parser.parse(argc, argv, result));
+        REQUIRE(result.generation() == generation);
+        REQUIRE(result.version(count) == 1);
+        REQUIRE(result.version(verbose) == 1);
+        REQUIRE(result.version(weight) == 1);
+        REQUIRE(result.subcommand_result().version("jobs") == jobs);
+
+        const std::string snapshot = parser.save_snapshot(result);
+        REQUIRE(parser.load_snapshot(snapshot.data(), snapshot.size(), result));
+        REQUIRE(result.generation() == generation);
+
+        // only what differs does
+        const char *other[] = {"prg", "-c", "3", "-w", "1,2", "build", "-j", "9"};
+        REQUIRE(parser.parse(8, other, result));
+        REQUIRE(result.version(count) == 1);
+        REQUIRE(result.version(verbose) == 2);
+        REQUIRE(result.version(weight) == 2);
+        REQUIRE(result.subcommand_result().version("jobs") == jobs + 1);
+    }
 }
@@ -0,0 +1,143 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include <string>
+#include <vector>
+
+#include "options/Parser.hpp"
+#include "options/Response_File.hpp"
+
+#include "Temporary_File.hpp"
+
+namespace
+{
+    std::vector<std::string> tokenize(const std::string &contents)
+    {
+        const Temporary_File file("options_tokenize.rsp", contents);
+
+        Options::Mapped_File mapped_file;
+        REQUIRE(mapped_file.open(file.path().c_str()));
+
+        Options::Response_File response_file(mapped_file);
+        std::vector<std::string> result;
+        while (const char *token = response_file.next())
+            result.emplace_back(token);
+
+        return result;
+    }
+} // namespace
+
+TEST_CASE("Response_File")
+{
+    SECTION("Splitting into tokens")
+    {
+        REQUIRE(tokenize("").empty());
+        REQUIRE(tokenize(" \n\t ").empty());
+        REQUIRE(tokenize("one") == std::vector<std::string>{"one"});
+        REQUIRE(tokenize("one two\nthree\r\n") == std::vector<std::string>{"one", "two", "three"});
+        REQUIRE(tokenize("  -n  'with space'  ") == std::vector<std::string>{"-n", "with space"});
+        REQUIRE(tokenize("\"double 'quoted'\" x") == std::vector<std::string>{"double 'quoted'", "x"});
+        REQUIRE(tokenize("a\\ b 'c\\d' \"e\\\"f\"") == std::vector<std::string>{"a b", "c\\d", "e\"f"});
+        REQUIRE(tokenize("pre'fix'post \"\"") == std::vector<std::string>{"prefixpost", ""});
+
+        // the tokens before an unterminated quote are returned, then the file is malformed
+        REQUIRE(tokenize("a 'b c") == std::vector<std::string>{"a"});
+        REQUIRE(tokenize("\"").empty());
+    }
+
+    SECTION("Missing file")
+    {
+        Options::Mapped_File mapped_file;
+        REQUIRE_FALSE(mapped_file.open("options_does_not_exist.rsp"));
+    }
+
+    SECTION("Parsing")
+    {
+        Options::Parser parser;
+        const auto name = parser.add_mandatory("name", 'n', "Name");
+        const auto count = parser.add_optional("count", 'c', "Count", "0");
+
+        std::string contents = "--name 'from file' -c 5 -- ";
+        for (int i = 0; i < 10000; ++i)
+            contents += "file_" + std::to_string(i) + "\n";
+
+        const Temporary_File file("options_parsing.rsp", contents);
+        const std::string at_path = "@" + file.path();
+
+        SECTION("disabled by default")
+        {
+            const char *argv[] = {"prg", at_path.c_str()};
+            REQUIRE_FALSE(parser.parse(2, argv));
+        }
+
+        parser.set_response_files(true);
+
+        SECTION("arguments from the file")
+        {
+            const char *argv[] = {"prg", at_path.c_str()};
+            REQUIRE(parser.parse(2, argv));
+
+            REQUIRE(parser.as_string(name) == "from file");
+            REQUIRE(parser.as_int(count) == 5);
+            REQUIRE(parser.positional_count() == 10000);
+            REQUIRE(parser.positional(0) == "file_0");
+            REQUIRE(parser.positional(9999) == "file_9999");
+        }
+
+        SECTION("mixed with argv")
+        {
+            const char *argv[] = {"prg", "-c", "1", at_path.c_str(), "last"};
+            REQUIRE(parser.parse(5, argv));
+
+            REQUIRE(parser.as_int(count) == 5); // the file comes later
+            REQUIRE(parser.positional_count() == 10001);
+            REQUIRE(parser.positional(10000) == "last");
+        }
+
+        SECTION("missing file")
+        {
+            const char *argv[] = {"prg", "-n", "x", "@options_does_not_exist.rsp"};
+            REQUIRE_FALSE(parser.parse(4, argv));
+        }
+
+        SECTION("not expanded after \"--\"")
+        {
+            const char *argv[] = {"prg", "-n", "x", "--", at_path.c_str(), "@options_does_not_exist.rsp"};
+            REQUIRE(parser.parse(6, argv));
+
+            REQUIRE(parser.positional_count() == 2);
+            REQUIRE(parser.positional(0) == at_path);
+            REQUIRE(parser.positional(1) == "@options_does_not_exist.rsp");
+        }
+
+        SECTION("\"--\" in the file")
+        {
+            const char *argv[] = {"prg", at_path.c_str(), at_path.c_str()};
+            REQUIRE(parser.parse(3, argv));
+
+            REQUIRE(parser.positional_count() == 10001);
+            REQUIRE(parser.positional(10000) == at_path);
+        }
+
+        SECTION("unterminated quote")
+        {
+            const Temporary_File malformed("options_malformed.rsp", "--name 'from file -c 5\n");
+            const std::string at_malformed = "@" + malformed.path();
+
+            const char *argv[] = {"prg", "-n", "x", at_malformed.c_str()};
+            REQUIRE_FALSE(parser.parse(4, argv));
+            REQUIRE(parser.diagnostic().error == Options::Error::Malformed_Response_File);
+            REQUIRE(parser.diagnostic().argv_index == 3);
+        }
+
+        SECTION("into a separate result")
+        {
+            parser.freeze();
+
+            Options::Parse_Result result;
+            const char *argv[] = {"prg", at_path.c_str()};
+            REQUIRE(parser.parse(2, argv, result));
+            REQUIRE(result.as_string(name) == "from file");
+            REQUIRE(result.positional_count() == 10000);
+        }
+    }
+}
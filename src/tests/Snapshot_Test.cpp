@@ -0,0 +1,181 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdlib>
+#include <string>
+
+#include "options/Option.hpp"
+#include "options/Parser.hpp"
+
+namespace
+{
+    int validator_calls = 0;
+
+    bool counting_validator(const Options::Value &value)
+    {
+        ++validator_calls;
+        return value.is_int64();
+    }
+
+    void define_build(Options::Parser &parser)
+    {
+        parser.add_optional("jobs", 'j', "Number of jobs", "1");
+        parser.add_flag("release", "Release build");
+    }
+
+    void define_options(Options::Parser &parser)
+    {
+        parser.add_mandatory("name", 'n', "Name");
+        parser.add_optional("count", 'c', "Count", "0", counting_validator);
+        parser.add_optional("ratio", "Ratio", "0.5");
+        parser.add_optional("user", "User name", "nobody");
+        parser.add_flag("verbose", 'v', "Verbose");
+        parser.add_multiple("weight", 'w', "Weights", ',');
+        parser.add_choice("level", "Level", {"low", "mid", "high"}, "low");
+        parser.add_subcommand("build", "Build the project", define_build);
+    }
+} // namespace
+
+TEST_CASE("Snapshot")
+{
+    Options::Parser parser;
+    define_options(parser);
+    parser.bind_env(parser.find("user"), "OPTIONS_SNAPSHOT_USER");
+
+    setenv("OPTIONS_SNAPSHOT_USER", "alice", 1);
+
+    const char *argv[] = {"prg",     "-n", "some name", "-c",       "42", "-w", "1.5,2", "-w", "-3",
+                          "--level", "high", "-v",      "--ratio", "0.25", "build", "-j", "8", "--", "target"};
+    const int argc = sizeof(argv) / sizeof(char *);
+
+    validator_calls = 0;
+    REQUIRE(parser.parse(argc, argv));
+    REQUIRE(validator_calls == 1);
+
+    const std::string snapshot = parser.save_snapshot();
+
+    SECTION("Restoring into the parser")
+    {
+        Options::Parser restored;
+        define_options(restored);
+        restored.bind_env(restored.find("user"), "OPTIONS_SNAPSHOT_USER");
+
+        std::string copy = snapshot;
+        REQUIRE(restored.load_snapshot(copy.data(), copy.size()));
+        copy.assign(copy.size(), 'x'); // the result owns copies of the texts
+
+        REQUIRE(validator_calls == 1); // nothing validated again
+        REQUIRE(restored.as_string("name") == "some name");
+        REQUIRE(restored.as_int("count") == 42);
+        REQUIRE(restored.as_int64("count") == 42);
+        REQUIRE(restored.as_double("ratio") == 0.25);
+        REQUIRE(restored.as_string("user") == "alice");
+        REQUIRE(restored.as_bool("verbose"));
+        REQUIRE(restored.as_choice("level") == 2);
+
+        const auto weights = restored.as_doubles(restored.find("weight"));
+        REQUIRE(weights.size() == 3);
+        REQUIRE(weights[0] == 1.5);
+        REQUIRE(weights[2] == -3.0);
+        REQUIRE(restored.as_strings(restored.find("weight"))[1] == "2");
+
+        REQUIRE(restored.diagnostic().error == Options::Error::None);
+        REQUIRE(restored.subcommand_name() == "build");
+        REQUIRE(restored.positional_count() == 0);
+
+        Options::Parser &build = restored.subcommand("build");
+        REQUIRE(build.as_int("jobs") == 8);
+        REQUIRE_FALSE(build.as_bool("release"));
+        REQUIRE(build.positional(0) == "target");
+    }
+
+    SECTION("Sources")
+    {
+        Options::Parse_Result result;
+        parser.freeze();
+        REQUIRE(parser.load_snapshot(snapshot.data(), snapshot.size(), result));
+
+        REQUIRE(result.source("name") == Options::Source::Command_Line);
+        REQUIRE(result.source("user") == Options::Source::Environment);
+        REQUIRE(result.was_set("verbose"));
+        REQUIRE_FALSE(result.subcommand_result().was_set("release"));
+        REQUIRE(result.subcommand_result().as_int("jobs") == 8);
+
+        // a snapshot of a separate result is the same
+        REQUIRE(parser.save_snapshot(result) == snapshot);
+    }
+
+    SECTION("Defaults are not stored")
+    {
+        Options::Parser small;
+        small.add_optional("count", "Count", "7");
+
+        const char *none[] = {"prg"};
+        REQUIRE(small.parse(1, none));
+
+        const std::string defaults = small.save_snapshot();
+        REQUIRE(defaults.size() < 32);
+
+        REQUIRE(small.load_snapshot(defaults.data(), defaults.size()));
+        REQUIRE(small.as_int("count") == 7);
+    }
+
+    SECTION("Different options")
+    {
+        Options::Parser other;
+        define_options(other);
+        other.add_flag("extra", "One more");
+
+        REQUIRE(other.schema_fingerprint() != parser.schema_fingerprint());
+        REQUIRE_FALSE(other.load_snapshot(snapshot.data(), snapshot.size()));
+        REQUIRE(other.diagnostic().error == Options::Error::Schema_Mismatch);
+        REQUIRE(other.as_string("name").empty());
+
+        Options::Parser other_default;
+        other_default.add_optional("count", "Count", "7");
+        Options::Parser same_names;
+        same_names.add_optional("count", "Count", "8");
+        REQUIRE(other_default.schema_fingerprint() != same_names.schema_fingerprint());
+
+        // the fingerprint depends only on the options
+        REQUIRE(parser.clone_schema()->schema_fingerprint() == parser.schema_fingerprint());
+        parser.freeze();
+        REQUIRE(parser.clone_schema()->schema_fingerprint() == parser.schema_fingerprint());
+    }
+
+    SECTION("Damaged snapshots")
+    {
+        Options::Parser restored;
+        define_options(restored);
+
+        for (size_t size = 0; size < snapshot.size(); ++size)
+        {
+            REQUIRE_FALSE(restored.load_snapshot(snapshot.data(), size));
+            REQUIRE(restored.diagnostic().error == Options::Error::Malformed_Snapshot);
+            REQUIRE(restored.subcommand_name().empty());
+        }
+
+        const std::string longer = snapshot + '\0';
+        REQUIRE_FALSE(restored.load_snapshot(longer.data(), longer.size()));
+        REQUIRE(restored.diagnostic().error == Options::Error::Malformed_Snapshot);
+
+        const std::string garbage = "not a snapshot at all";
+        REQUIRE_FALSE(restored.load_snapshot(garbage.data(), garbage.size()));
+        REQUIRE(restored.diagnostic().error == Options::Error::Malformed_Snapshot);
+
+        REQUIRE(restored.load_snapshot(snapshot.data(), snapshot.size()));
+        REQUIRE(restored.as_string("name") == "some name");
+    }
+
+    SECTION("Result of another parser")
+    {
+        Options::Parser other;
+        define_options(other);
+        other.freeze();
+
+        Options::Parse_Result result;
+        REQUIRE(other.load_snapshot(snapshot.data(), snapshot.size(), result));
+        REQUIRE_THROWS(parser.save_snapshot(result));
+    }
+
+    unsetenv("OPTIONS_SNAPSHOT_USER");
+}
@@ -0,0 +1,121 @@
+#include <string>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "options/Static_Parser.hpp"
+
+namespace
+{
+    namespace Static = Options::Static;
+
+    constexpr Static::Spec SPECS[] = {
+        Static::mandatory<const char *>("mode", 'm', "Operation mode"),
+        Static::optional("count", 'c', "Count", 10),
+        Static::optional("size", "Size", 4096U),
+        Static::optional("ratio", 'r', "Ratio", 0.5),
+        Static::optional("name", "Name", "nobody"),
+        Static::flag("verbose", 'v', "Verbose"),
+        Static::flag("debug", "Debug"),
+        Static::optional("color", "Colored output", true),
+        Static::mandatory<bool>("force", "Force"),
+    };
+
+    using Args = Static::Parser<SPECS>;
+
+    constexpr size_t MODE = Args::index_of("mode");
+    constexpr size_t COUNT = Args::index_of("count");
+    constexpr size_t SIZE = Args::index_of("size");
+    constexpr size_t RATIO = Args::index_of("ratio");
+    constexpr size_t NAME = Args::index_of("name");
+    constexpr size_t VERBOSE = Args::index_of("verbose");
+    constexpr size_t DEBUG = Args::index_of("debug");
+    constexpr size_t COLOR = Args::index_of("color");
+    constexpr size_t FORCE = Args::index_of("force");
+
+    static_assert(COUNT == 1, "lookup of names is done at compile time");
+    static_assert(Args::index_of("non_existing") == std::size(SPECS), "unknown names are not found");
+} // namespace
+
+TEST_CASE("Static parser")
+{
+    Args args;
+
+    SECTION("Defaults")
+    {
+        const char *argv[] = {"prg", "--mode", "fast", "--force", "0"};
+        REQUIRE(args.parse(sizeof(argv) / sizeof(char *), argv));
+
+        REQUIRE(args.get<MODE>() == "fast");
+        REQUIRE(args.was_set<MODE>());
+
+        REQUIRE(args.get<COUNT>() == 10);
+        REQUIRE_FALSE(args.was_set<COUNT>());
+        REQUIRE(args.get<SIZE>() == 4096);
+        REQUIRE(args.get<RATIO>() == 0.5);
+        REQUIRE(args.get<NAME>() == "nobody");
+        REQUIRE_FALSE(args.get<VERBOSE>());
+        REQUIRE_FALSE(args.get<DEBUG>());
+        REQUIRE(args.get<COLOR>());
+        REQUIRE_FALSE(args.get<FORCE>());
+        REQUIRE(args.positionals().empty());
+    }
+
+    SECTION("Values of all the types")
+    {
+        const char *argv[] = {"prg",     "-m",    "slow",    "-c",   "-5", "--size", "2k", "-r",
+                              "1e3",     "--name", "bob",   "-v",    "--debug", "--color",
+                              "false",   "--force", "true", "--",    "a",       "b"};
+        REQUIRE(args.parse(sizeof(argv) / sizeof(char *), argv));
+
+        REQUIRE(args.get<MODE>() == "slow");
+        REQUIRE(args.get<COUNT>() == -5);
+        REQUIRE(args.get<SIZE>() == 2048);
+        REQUIRE(args.get<RATIO>() == 1000.0);
+        REQUIRE(args.get<NAME>().data() == argv[10]);
+        REQUIRE(args.get<VERBOSE>());
+        REQUIRE(args.get<DEBUG>());
+        REQUIRE_FALSE(args.get<COLOR>());
+        REQUIRE(args.get<FORCE>());
+
+        REQUIRE(args.positionals().size() == 2);
+        REQUIRE(std::string(args.positionals()[0]) == "a");
+        REQUIRE(std::string(args.positionals()[1]) == "b");
+    }
+
+    SECTION("Every parse starts from the defaults")
+    {
+        const char *first[] = {"prg", "--mode", "x", "--force", "1", "-c", "3", "-v", "--", "p"};
+        REQUIRE(args.parse(sizeof(first) / sizeof(char *), first));
+
+        const char *second[] = {"prg", "--force", "1"};
+        REQUIRE_FALSE(args.parse(3, second)); // the mode is missing now
+
+        const char *third[] = {"prg", "--mode", "y", "--force", "0"};
+        REQUIRE(args.parse(5, third));
+        REQUIRE(args.get<COUNT>() == 10);
+        REQUIRE_FALSE(args.was_set<COUNT>());
+        REQUIRE_FALSE(args.get<VERBOSE>());
+        REQUIRE(args.positionals().empty());
+    }
+
+    SECTION("Failures")
+    {
+        const char *missing_mandatory[] = {"prg", "-v", "--force", "1"};
+        REQUIRE_FALSE(args.parse(4, missing_mandatory));
+
+        const char *invalid_bool[] = {"prg", "--mode", "x", "--force", "yes"};
+        REQUIRE_FALSE(args.parse(5, invalid_bool));
+
+        const char *missing_value[] = {"prg", "--mode"};
+        REQUIRE_FALSE(args.parse(2, missing_value));
+
+        const char *unknown_option[] = {"prg", "--mode", "x", "--unknown"};
+        REQUIRE_FALSE(args.parse(4, unknown_option));
+
+        const char *invalid_number[] = {"prg", "--mode", "x", "--count", "12abc"};
+        REQUIRE_FALSE(args.parse(5, invalid_number));
+
+        const char *negative_unsigned[] = {"prg", "--mode", "x", "--size", "-1"};
+        REQUIRE_FALSE(args.parse(5, negative_unsigned));
+    }
+}
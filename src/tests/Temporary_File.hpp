@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+// Creates a file with the given contents and removes it when going out of scope.
+class Temporary_File
+{
+public:
+    Temporary_File(const std::string &path, const std::string &contents) : _path{path}
+    {
+        FILE *file = fopen(_path.c_str(), "wb");
+        if (file != nullptr)
+        {
+            fwrite(contents.data(), 1, contents.size(), file);
+            fclose(file);
+        }
+    }
+
+    ~Temporary_File() { remove(_path.c_str()); }
+
+    Temporary_File(const Temporary_File &) = delete;
+    Temporary_File &operator=(const Temporary_File &) = delete;
+
+    const std::string &path() const { return _path; }
+
+private:
+    std::string _path;
+};
@@ -0,0 +1,142 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include <string>
+
+#include "options/Parser.hpp"
+#include "options/Validator.hpp"
+
+namespace
+{
+    bool check(const Options::Validator &validator, const char *text)
+    {
+        return validator(Options::Value(text));
+    }
+
+    bool is_even(const Options::Value &value)
+    {
+        return value.as_int64() % 2 == 0;
+    }
+} // namespace
+
+TEST_CASE("Validator")
+{
+    SECTION("Default accepts everything")
+    {
+        const Options::Validator validator;
+        REQUIRE_FALSE(validator);
+        REQUIRE(check(validator, "anything"));
+    }
+
+    SECTION("Functions and callables")
+    {
+        const Options::Validator function{is_even};
+        REQUIRE(function);
+        REQUIRE(check(function, "4"));
+        REQUIRE_FALSE(check(function, "5"));
+
+        const int64_t limit = 10;
+        const Options::Validator callable = [limit](const Options::Value &value) {
+            return value.as_int64() < limit;
+        };
+        REQUIRE(check(callable, "9"));
+        REQUIRE_FALSE(check(callable, "10"));
+
+        const Options::Validator copy = callable; // shares the callable
+        REQUIRE(check(copy, "9"));
+    }
+
+    SECTION("Ranges")
+    {
+        const auto ints = Options::int_range(-10, 10);
+        REQUIRE(check(ints, "-10"));
+        REQUIRE(check(ints, "0x0a"));
+        REQUIRE_FALSE(check(ints, "11"));
+        REQUIRE_FALSE(check(ints, "5abc"));
+        REQUIRE_FALSE(check(ints, ""));
+
+        const auto uints = Options::uint_range(1, 4096);
+        REQUIRE(check(uints, "4k"));
+        REQUIRE_FALSE(check(uints, "0"));
+        REQUIRE_FALSE(check(uints, "-1"));
+
+        const auto doubles = Options::double_range(0.0, 1.0);
+        REQUIRE(check(doubles, "0.5"));
+        REQUIRE(check(doubles, "1e-3"));
+        REQUIRE_FALSE(check(doubles, "1.5"));
+        REQUIRE_FALSE(check(doubles, "0.5x"));
+        REQUIRE_FALSE(check(doubles, "nan"));
+    }
+
+    SECTION("Set of strings")
+    {
+        const auto levels = Options::one_of({"none", "debug", "error"});
+        REQUIRE(check(levels, "none"));
+        REQUIRE(check(levels, "error"));
+        REQUIRE_FALSE(check(levels, "err"));
+        REQUIRE_FALSE(check(levels, "errors"));
+        REQUIRE_FALSE(check(levels, ""));
+    }
+
+    SECTION("Patterns")
+    {
+        REQUIRE(check(Options::matches("*.txt"), "notes.txt"));
+        REQUIRE(check(Options::matches("*.txt"), ".txt"));
+        REQUIRE_FALSE(check(Options::matches("*.txt"), "notes.txt.bak"));
+        REQUIRE(check(Options::matches("file_??.log"), "file_01.log"));
+        REQUIRE_FALSE(check(Options::matches("file_??.log"), "file_1.log"));
+        REQUIRE(check(Options::matches("*a*b*c"), "xxaxxbxbxxc"));
+        REQUIRE_FALSE(check(Options::matches("*a*b*c"), "xxaxxbxbxxcd"));
+        REQUIRE(check(Options::matches("[a-c]x[!0-9]"), "bxy"));
+        REQUIRE_FALSE(check(Options::matches("[a-c]x[!0-9]"), "bx5"));
+        REQUIRE_FALSE(check(Options::matches("[a-c]x[!0-9]"), "dxy"));
+        REQUIRE(check(Options::matches("a\\*"), "a*"));
+        REQUIRE_FALSE(check(Options::matches("a\\*"), "ab"));
+        REQUIRE(check(Options::matches("[]x]"), "]"));
+        REQUIRE(check(Options::matches("[x"), "[x"));
+        REQUIRE(check(Options::matches("*"), ""));
+        REQUIRE_FALSE(check(Options::matches("?"), ""));
+    }
+
+    SECTION("Used by a parser")
+    {
+        Options::Parser parser;
+
+        const auto jobs = parser.add_optional("jobs", 'j', "Number of jobs", "1", Options::int_range(1, 64));
+        const auto level = parser.add_optional("level", "Level", "none", Options::one_of({"none", "debug"}));
+        const auto inputs = parser.add_multiple("input", 'i', "Inputs", ',', Options::matches("*.txt"));
+        parser.add_optional("text", "Text validator", "a", [](const std::string &value) { return !value.empty(); });
+        parser.add_optional("value", "Value validator", "2", [](const Options::Value &value) {
+            return value.as_int() > 0;
+        });
+
+        const char *argv[] = {"prg", "-j", "8", "--level", "debug", "-i", "a.txt,b.txt"};
+        REQUIRE(parser.parse(7, argv));
+        REQUIRE(parser.as_int(jobs) == 8);
+        REQUIRE(parser.as_string(level) == "debug");
+        REQUIRE(parser.as_strings(inputs).size() == 2);
+
+        // the validated value is the one returned
+        parser.reset();
+        const char *octal[] = {"prg", "-j", "011"};
+        REQUIRE(parser.parse(3, octal));
+        REQUIRE(parser.as_int(jobs) == 9);
+        REQUIRE(parser.as_uint(jobs) == 9);
+
+        parser.reset();
+        const char *hexadecimal[] = {"prg", "-j", "0x7"};
+        REQUIRE(parser.parse(3, hexadecimal));
+        REQUIRE(parser.as_int(jobs) == 7);
+        REQUIRE(parser.as_int64(jobs) == 7);
+
+        parser.reset();
+        const char *invalid[] = {"prg", "-i", "a.txt,b.doc"};
+        REQUIRE_FALSE(parser.parse(3, invalid));
+        REQUIRE(parser.diagnostic().error == Options::Error::Invalid_Value);
+        REQUIRE(parser.diagnostic().option == inputs);
+
+        parser.reset();
+        const char *out_of_range[] = {"prg", "--jobs", "65"};
+        REQUIRE_FALSE(parser.parse(3, out_of_range));
+        REQUIRE(parser.diagnostic().option == jobs);
+    }
+}
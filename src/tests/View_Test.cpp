@@ -0,0 +1,51 @@
+#include <sstream>
+#include <string>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "options/View.hpp"
+
+TEST_CASE("View")
+{
+    SECTION("Empty view")
+    {
+        Options::View view;
+
+        REQUIRE(view.empty());
+        REQUIRE(view.size() == 0);
+        REQUIRE(view.c_str()[0] == '\0');
+        REQUIRE(view == "");
+        REQUIRE(view.str().empty());
+    }
+
+    SECTION("View of a part of a text")
+    {
+        const char *text = "hello world";
+        Options::View view(text + 6, 5);
+
+        REQUIRE(view.size() == 5);
+        REQUIRE(view == "world");
+        REQUIRE(view != "worl");
+        REQUIRE(view != "worlds");
+        REQUIRE(view[0] == 'w');
+        REQUIRE(std::string(view.begin(), view.end()) == "world");
+    }
+
+    SECTION("Comparing with strings and converting to them")
+    {
+        const std::string text = "some text";
+        Options::View view(text);
+
+        REQUIRE(view.data() == text.data());
+        REQUIRE(view == text);
+        REQUIRE(text == view);
+
+        const std::string copy = view;
+        REQUIRE(copy == text);
+        REQUIRE(copy.data() != text.data());
+
+        std::ostringstream stream;
+        stream << '[' << view << ']';
+        REQUIRE(stream.str() == "[some text]");
+    }
+}